@@ -0,0 +1,778 @@
+/*
+ *      rpnbench.c
+ *      by Cansu Birsen (cbirse01), Ayse Idil Kolabas (akolab01)
+ *      December 8, 2023
+ *      Assembly Lang RPN
+ *
+ *      Throughput benchmark for calc40. Generates long calc40 input
+ *      streams, evaluates them with a reference RPN calculator written to
+ *      match calc40.ums token for token, and runs calc40.um on a um to
+ *      report tokens per second and UM instructions per token, checking
+ *      the output against the reference.
+ *
+ *      Usage: rpnbench gen [-t tokens] [-s seed] [-d depth] > input
+ *             rpnbench ref < input > expected
+ *             rpnbench run [-o dir] [-t tokens] [-s seed] [-d depth] um
+ *                          calc40.um
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+/* a newline, which prints the whole value stack, every this many tokens */
+#define DUMP_EVERY 64
+
+/* the generator keeps the value stack between these depths */
+#define MIN_DEPTH 2
+#define MAX_DEPTH 16
+
+/* what the reference calculator does with the next character */
+enum rpn_mode {
+        WAITING,        /* waiting: any character starts a token */
+        ENTERING,       /* entering: a digit extends the number on top */
+        REPEATING       /* repeat: the character after a count and x */
+};
+
+/* the reference calculator */
+typedef struct rpn_state {
+        uint32_t *stack;
+        uint32_t depth;
+        uint32_t capacity;
+        enum rpn_mode mode;
+        uint32_t count;         /* count popped by x */
+        FILE *out;              /* NULL to discard the output */
+} rpn_state;
+
+/* printed before the random tokens, the values printd finds hardest: one
+ * digit, a new power of ten, the largest powers and the most negative
+ * number, which is 2147483647 + 1 */
+static const char printd_values[] = "0 9 10 1000000000 2147483647 "
+                                    "2147483647 1 +\nz ";
+
+/* state of the xorshift generator picking tokens */
+static uint64_t rng_state;
+
+static void rpn_dispatch(rpn_state *st, int c);
+
+/******************************** rpn_push *********************************
+ *
+ * Pushes a value on the reference value stack, growing it when full
+ *
+ * Inputs:
+ *              rpn_state *st: the calculator
+ *              uint32_t value: value to push
+ * Return:
+ *              none
+ * Expects:
+ *              st to not be null and allocation to succeed
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static void rpn_push(rpn_state *st, uint32_t value)
+{
+        assert(st != NULL);
+
+        if (st->depth == st->capacity) {
+                st->capacity = st->capacity == 0 ? 1024 : 2 * st->capacity;
+                st->stack = realloc(st->stack,
+                                    st->capacity * sizeof(uint32_t));
+                assert(st->stack != NULL);
+        }
+        st->stack[st->depth++] = value;
+}
+
+/* writes calc40 output, unless it is being discarded */
+static void say(rpn_state *st, const char *text)
+{
+        if (st->out != NULL) {
+                fputs(text, st->out);
+        }
+}
+
+/******************************** divide *********************************
+ *
+ * Divides as the divide macro of calc40.umm does: the magnitudes are
+ * divided unsigned and the sign of the result is set after
+ *
+ * Inputs:
+ *              uint32_t dividend, divisor: signed values as words
+ * Return:
+ *              the quotient rounded toward zero, as a word
+ * Expects:
+ *              divisor to not be 0
+ * Notes:
+ *              the most negative number divides like 2^31
+ *
+ *****************************************************************************/
+static uint32_t divide(uint32_t dividend, uint32_t divisor)
+{
+        assert(divisor != 0);
+
+        if ((int32_t)dividend > 0) {
+                if ((int32_t)divisor < 0) {
+                        return -(dividend / -divisor);
+                }
+                return dividend / divisor;
+        }
+        if ((int32_t)divisor > 0) {
+                return -(-dividend / divisor);
+        }
+        return -dividend / -divisor;
+}
+
+/* applies binary operator op to the second element b and the top a */
+static uint32_t apply(int op, uint32_t b, uint32_t a)
+{
+        switch (op) {
+        case '+': return b + a;
+        case '-': return b - a;
+        case '*': return b * a;
+        case '|': return b | a;
+        case '&': return b & a;
+        default:  return divide(b, a);
+        }
+}
+
+/******************************** print_stack ********************************
+ *
+ * Prints the value stack from the top down, one ">>> " line per value, as
+ * newline and printd do
+ *
+ * Inputs:
+ *              rpn_state *st: the calculator
+ * Return:
+ *              none
+ * Expects:
+ *              st to not be null
+ * Notes:
+ *              values print as signed decimals
+ *
+ *****************************************************************************/
+static void print_stack(rpn_state *st)
+{
+        if (st->out == NULL) {
+                return;
+        }
+        for (uint32_t i = st->depth; i-- > 0;) {
+                fprintf(st->out, ">>> %" PRId32 "\n", (int32_t)st->stack[i]);
+        }
+}
+
+/******************************** binary *********************************
+ *
+ * Runs a binary operator token, as the operators after access_two_elt do
+ *
+ * Inputs:
+ *              rpn_state *st: the calculator
+ *              int op: one of + - * / | &
+ * Return:
+ *              none
+ * Expects:
+ *              st to not be null
+ * Notes:
+ *              underflow and division by zero leave the stack unchanged
+ *
+ *****************************************************************************/
+static void binary(rpn_state *st, int op)
+{
+        if (st->depth < 2) {
+                say(st, "Stack underflow---expected at least 2 elements\n");
+                return;
+        }
+
+        uint32_t a = st->stack[st->depth - 1];
+        uint32_t b = st->stack[st->depth - 2];
+        if (op == '/' && a == 0) {
+                say(st, "Division by zero\n");
+                return;
+        }
+        st->depth -= 2;
+        rpn_push(st, apply(op, b, a));
+}
+
+/******************************** repeat *********************************
+ *
+ * Runs the character after "N x", as the repeattable entries do: a binary
+ * operator is applied N times and anything else is handled as usual with
+ * N put back
+ *
+ * Inputs:
+ *              rpn_state *st: the calculator, with the count in st->count
+ *              int c: the character
+ * Return:
+ *              none
+ * Expects:
+ *              st to not be null
+ * Notes:
+ *              a count of 0 or less is dropped along with the operator
+ *
+ *****************************************************************************/
+static void repeat(rpn_state *st, int c)
+{
+        int32_t n = (int32_t)st->count;
+
+        if (c == EOF || strchr("&*+-/|", c) == NULL) {
+                rpn_push(st, st->count);
+                rpn_dispatch(st, c);
+                return;
+        }
+        if (n <= 0) {
+                return;
+        }
+        if ((int32_t)st->depth <= n) {
+                rpn_push(st, st->count);
+                say(st, "Stack underflow---expected N + 1 elements below "
+                        "N\n");
+                return;
+        }
+
+        /* folds the top element with the n below it, from the top down */
+        uint32_t limit = st->depth - n - 1;
+        uint32_t result = st->stack[--st->depth];
+        while (st->depth > limit) {
+                uint32_t next = st->stack[--st->depth];
+                if (c == '/' && result == 0) {
+                        st->depth++;
+                        rpn_push(st, result);
+                        say(st, "Division by zero\n");
+                        return;
+                }
+                result = apply(c, next, result);
+        }
+        rpn_push(st, result);
+}
+
+/******************************** rpn_dispatch *******************************
+ *
+ * Runs the token a character starts, as the jumptable entries do
+ *
+ * Inputs:
+ *              rpn_state *st: the calculator
+ *              int c: the character
+ * Return:
+ *              none
+ * Expects:
+ *              st to not be null
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static void rpn_dispatch(rpn_state *st, int c)
+{
+        uint32_t top = st->depth > 0 ? st->stack[st->depth - 1] : 0;
+        uint32_t result = 0;
+
+        st->mode = WAITING;
+        switch (c) {
+        case EOF:
+        case ' ':
+                return;
+        case '\n':
+                print_stack(st);
+                return;
+        case '+': case '-': case '*': case '/': case '|': case '&':
+                binary(st, c);
+                return;
+        case 'z':
+                st->depth = 0;
+                return;
+        case 'c': case '~': case 'd': case 'p': case 'x':
+        case 'S': case 'P': case 'A': case 'O':
+                if (st->depth == 0) {
+                        say(st, "Stack underflow---expected at least 1 "
+                                "element\n");
+                        return;
+                }
+                break;
+        case 's':
+                if (st->depth < 2) {
+                        say(st, "Stack underflow---expected at least 2 "
+                                "elements\n");
+                        return;
+                }
+                st->stack[st->depth - 1] = st->stack[st->depth - 2];
+                st->stack[st->depth - 2] = top;
+                return;
+        default:
+                if (c >= '0' && c <= '9') {
+                        rpn_push(st, c - '0');
+                        st->mode = ENTERING;
+                        return;
+                }
+                if (st->out != NULL) {
+                        fprintf(st->out, "Unknown character '%c'\n", c);
+                }
+                return;
+        }
+
+        /* one element operators, the stack is not empty */
+        switch (c) {
+        case 'c':
+                st->stack[st->depth - 1] = -top;
+                return;
+        case '~':
+                st->stack[st->depth - 1] = ~top;
+                return;
+        case 'd':
+                rpn_push(st, top);
+                return;
+        case 'p':
+                st->depth--;
+                return;
+        case 'x':
+                st->count = top;
+                st->depth--;
+                st->mode = REPEATING;
+                return;
+        default:
+                break;
+        }
+
+        /* bulk operators fold the whole stack from the top down */
+        result = top;
+        for (uint32_t i = st->depth - 1; i-- > 0;) {
+                uint32_t next = st->stack[i];
+                result = c == 'S' ? result + next :
+                         c == 'P' ? result * next :
+                         c == 'A' ? next & result : next | result;
+        }
+        st->depth = 0;
+        rpn_push(st, result);
+}
+
+/******************************** rpn_feed *********************************
+ *
+ * Gives the reference calculator the next input character
+ *
+ * Inputs:
+ *              rpn_state *st: the calculator
+ *              int c: the character
+ * Return:
+ *              none
+ * Expects:
+ *              st to not be null and c to not be EOF
+ * Notes:
+ *              calc40 stops at EOF whatever it was doing, so EOF needs no
+ *              call
+ *
+ *****************************************************************************/
+static void rpn_feed(rpn_state *st, int c)
+{
+        if (st->mode == ENTERING && c >= '0' && c <= '9') {
+                uint32_t *top = &st->stack[st->depth - 1];
+                *top = *top * 10 + (c - '0');
+                return;
+        }
+        if (st->mode == REPEATING) {
+                st->mode = WAITING;
+                repeat(st, c);
+                return;
+        }
+        rpn_dispatch(st, c);
+}
+
+/* evaluates all of fp with the reference calculator, printing to out */
+static void reference(FILE *fp, FILE *out)
+{
+        rpn_state st = { NULL, 0, 0, WAITING, 0, out };
+        int c;
+        while ((c = getc(fp)) != EOF) {
+                rpn_feed(&st, c);
+        }
+        free(st.stack);
+}
+
+/* returns a random number below n */
+static uint32_t random_below(uint32_t n)
+{
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 7;
+        rng_state ^= rng_state << 17;
+        return (uint32_t)((rng_state >> 32) % n);
+}
+
+/* writes a token to out and feeds it to the calculator tracking the stack */
+static void token(rpn_state *st, FILE *out, const char *text)
+{
+        for (const char *p = text; *p != '\0'; p++) {
+                putc(*p, out);
+                rpn_feed(st, *p);
+        }
+}
+
+/******************************** generate *********************************
+ *
+ * Writes a random calc40 input stream
+ *
+ * Inputs:
+ *              FILE *out: where the input is written
+ *              uint64_t tokens: number of tokens to write
+ *              uint64_t seed: seed of the generator
+ *              uint64_t depth: numbers pushed before the random tokens,
+ *                              or 0
+ * Return:
+ *              none
+ * Expects:
+ *              out to not be null
+ * Notes:
+ *              about half the tokens are numbers of 1 to 10 digits and a
+ *              third binary operators, the rest stack operators, bulk
+ *              operators and repeats. A newline every DUMP_EVERY tokens
+ *              prints the stack, which is kept between MIN_DEPTH and
+ *              MAX_DEPTH elements so the output stays proportional to
+ *              the input. Tokens are separated by spaces. printd_values
+ *              comes first and is not counted in tokens. Then depth
+ *              numbers, if any, are pushed, printed once and summed with
+ *              S, so the value stack segment has to grow past depth.
+ *              The input ends with a newline and a number with nothing
+ *              after it, which calc40 has to push at EOF and not print
+ *
+ *****************************************************************************/
+static void generate(FILE *out, uint64_t tokens, uint64_t seed,
+                     uint64_t depth)
+{
+        static const char binaries[] = "+-*|&+-*|&/";
+        static const char unaries[] = "dspc~";
+        rpn_state st = { NULL, 0, 0, WAITING, 0, NULL };
+        rng_state = seed * 2654435761u + 88172645463325252u;
+        token(&st, out, printd_values);
+
+        /* a deep stack, not counted in tokens either */
+        for (uint64_t i = 0; i < depth; i++) {
+                char text[16];
+                snprintf(text, sizeof(text), "%" PRIu32 " ",
+                         1 + random_below(999));
+                token(&st, out, text);
+        }
+        if (depth > 0) {
+                token(&st, out, "\nS ");
+        }
+
+        uint64_t written = 0;
+        while (written < tokens) {
+                char text[32];
+                uint32_t pick = random_below(100);
+
+                if (written % DUMP_EVERY == DUMP_EVERY - 1) {
+                        token(&st, out, "\n");
+                        written++;
+                        continue;
+                }
+
+                if (st.depth < MIN_DEPTH ||
+                    (st.depth < MAX_DEPTH && pick < 48)) {
+                        /* mostly short numbers, some up to ten digits */
+                        uint32_t digits = 1 + random_below(
+                                          pick % 5 == 0 ? 10 : 4);
+                        text[0] = '1' + random_below(9);
+                        for (uint32_t i = 1; i < digits; i++) {
+                                text[i] = '0' + random_below(10);
+                        }
+                        text[digits] = '\0';
+                } else if (st.depth >= MAX_DEPTH || pick < 82) {
+                        snprintf(text, sizeof(text), "%c",
+                                 binaries[random_below(sizeof(binaries) -
+                                                       1)]);
+                } else if (pick < 94) {
+                        snprintf(text, sizeof(text), "%c",
+                                 unaries[random_below(sizeof(unaries) -
+                                                      1)]);
+                } else if (pick < 95) {
+                        snprintf(text, sizeof(text), "z");
+                } else if (pick < 97) {
+                        snprintf(text, sizeof(text), "%c",
+                                 "SPAO"[random_below(4)]);
+                } else {
+                        /* applies an operator to part of the stack */
+                        token(&st, out, " ");
+                        snprintf(text, sizeof(text), "%" PRIu32,
+                                 1 + random_below(st.depth - 1));
+                        token(&st, out, text);
+                        token(&st, out, " x");
+                        snprintf(text, sizeof(text), "%c",
+                                 binaries[random_below(sizeof(binaries) -
+                                                       1)]);
+                        written += 2;
+                }
+
+                token(&st, out, text);
+                token(&st, out, " ");
+                written++;
+        }
+
+        /* prints the stack, then ends in the middle of a number */
+        token(&st, out, "\n1234567");
+
+        free(st.stack);
+}
+
+/******************************** run_um *********************************
+ *
+ * Runs a um on a program with its input and output redirected
+ *
+ * Inputs:
+ *              const char *um: path of the um executable
+ *              const char *flag: flag passed before the program, or NULL
+ *              const char *program: path of the .um program
+ *              const char *in, *out, *err: files for the standard streams,
+ *                                          err NULL to keep stderr
+ * Return:
+ *              user plus system CPU seconds of the run, or a negative number
+ *              if the um could not be run or did not exit with status 0
+ * Expects:
+ *              um, program, in and out to not be null
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static double run_um(const char *um, const char *flag, const char *program,
+                     const char *in, const char *out, const char *err)
+{
+        pid_t pid = fork();
+        if (pid < 0) {
+                return -1;
+        }
+
+        if (pid == 0) {
+                int in_fd = open(in, O_RDONLY);
+                int out_fd = open(out, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+                int err_fd = err == NULL ? STDERR_FILENO :
+                             open(err, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+                if (in_fd < 0 || out_fd < 0 || err_fd < 0) {
+                        _exit(127);
+                }
+                dup2(in_fd, STDIN_FILENO);
+                dup2(out_fd, STDOUT_FILENO);
+                dup2(err_fd, STDERR_FILENO);
+                if (flag != NULL) {
+                        execl(um, um, flag, program, (char *)NULL);
+                } else {
+                        execl(um, um, program, (char *)NULL);
+                }
+                _exit(127);
+        }
+
+        int status;
+        struct rusage usage;
+        if (wait4(pid, &status, 0, &usage) < 0 ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                return -1;
+        }
+
+        return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+               usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+/******************************** first_difference ***************************
+ *
+ * Compares two files
+ *
+ * Inputs:
+ *              const char *a, *b: paths of the files
+ * Return:
+ *              0 if they are the same, otherwise the line of the first
+ *              difference, counting from 1
+ * Expects:
+ *              both files to be readable
+ * Notes:
+ *              exits with EXIT_FAILURE if expectation fails
+ *
+ *****************************************************************************/
+static uint64_t first_difference(const char *a, const char *b)
+{
+        FILE *fa = fopen(a, "r"), *fb = fopen(b, "r");
+        if (fa == NULL || fb == NULL) {
+                fprintf(stderr, "Could not open %s or %s.\n", a, b);
+                exit(EXIT_FAILURE);
+        }
+
+        uint64_t line = 1, differs = 0;
+        int ca, cb;
+        do {
+                ca = getc(fa);
+                cb = getc(fb);
+                if (ca != cb) {
+                        differs = line;
+                        break;
+                }
+                line += ca == '\n';
+        } while (ca != EOF);
+
+        fclose(fa);
+        fclose(fb);
+        return differs;
+}
+
+/* reads the instruction count from the stderr of um --profile */
+static uint64_t profiled_instructions(const char *path)
+{
+        uint64_t count = 0;
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL) {
+                return 0;
+        }
+        if (fscanf(fp, "um profile: %" SCNu64 " instructions", &count) != 1) {
+                count = 0;
+        }
+        fclose(fp);
+        return count;
+}
+
+/******************************** run *********************************
+ *
+ * Writes an input stream and its reference output into dir, runs calc40
+ * on it and prints the throughput
+ *
+ * Inputs:
+ *              const char *dir: directory for the files of the run
+ *              uint64_t tokens: number of tokens of input
+ *              uint64_t seed: seed of the generator
+ *              uint64_t depth: numbers pushed first, as generate does
+ *              const char *um: path of the um executable
+ *              const char *program: path of calc40.um
+ * Return:
+ *              EXIT_SUCCESS if calc40 printed the reference output
+ * Expects:
+ *              dir to be writable
+ * Notes:
+ *              the instruction count comes from a second run with
+ *              --profile, which only the Optimized UM has, so the timed
+ *              run is not slowed down by counting
+ *
+ *****************************************************************************/
+static int run(const char *dir, uint64_t tokens, uint64_t seed,
+               uint64_t depth, const char *um, const char *program)
+{
+        char input[4096], expected[4096], output[4096], profile[4096];
+        snprintf(input, sizeof(input), "%s/input.txt", dir);
+        snprintf(expected, sizeof(expected), "%s/expected.txt", dir);
+        snprintf(output, sizeof(output), "%s/output.txt", dir);
+        snprintf(profile, sizeof(profile), "%s/profile.txt", dir);
+
+        if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+                fprintf(stderr, "Could not create %s.\n", dir);
+                return EXIT_FAILURE;
+        }
+
+        FILE *in = fopen(input, "w");
+        FILE *ref = fopen(expected, "w");
+        if (in == NULL || ref == NULL) {
+                fprintf(stderr, "Could not write into %s.\n", dir);
+                return EXIT_FAILURE;
+        }
+        generate(in, tokens, seed, depth);
+        fclose(in);
+        in = fopen(input, "r");
+        assert(in != NULL);
+        reference(in, ref);
+        fclose(in);
+        fclose(ref);
+
+        double seconds = run_um(um, NULL, program, input, output, NULL);
+        if (seconds < 0) {
+                fprintf(stderr, "%s %s failed.\n", um, program);
+                return EXIT_FAILURE;
+        }
+        uint64_t differs = first_difference(output, expected);
+
+        uint64_t instructions = 0;
+        if (run_um(um, "--profile", program, input, "/dev/null",
+                   profile) >= 0) {
+                instructions = profiled_instructions(profile);
+        }
+
+        printf("tokens             %12" PRIu64 "\n", tokens);
+        printf("seconds            %12.2f\n", seconds);
+        printf("tokens per second  %12.0f\n",
+               seconds > 0 ? tokens / seconds : 0.0);
+        if (instructions > 0) {
+                printf("instructions       %12" PRIu64 "\n", instructions);
+                printf("instructions/token %12.1f\n",
+                       (double)instructions / tokens);
+        } else {
+                printf("instructions       %12s\n", "no --profile");
+        }
+
+        if (differs != 0) {
+                printf("output differs from %s at line %" PRIu64 "\n",
+                       expected, differs);
+                return EXIT_FAILURE;
+        }
+        printf("output matches the reference\n");
+        return EXIT_SUCCESS;
+}
+
+static void usage(const char *prog)
+{
+        fprintf(stderr, "Usage: %s gen [-t tokens] [-s seed] [-d depth] "
+                        "> input\n"
+                        "       %s ref < input > expected\n"
+                        "       %s run [-o dir] [-t tokens] [-s seed] "
+                        "[-d depth] um calc40.um\n", prog, prog, prog);
+        exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+        const char *dir = "rpnbench.d";
+        uint64_t tokens = 2000000;
+        uint64_t seed = 1;
+        uint64_t depth = 0;
+
+        if (argc < 2) {
+                usage(argv[0]);
+        }
+        const char *mode = argv[1];
+
+        int i = 2;
+        for (; i < argc && argv[i][0] == '-'; i++) {
+                if (i + 1 == argc) {
+                        usage(argv[0]);
+                } else if (strcmp(argv[i], "-o") == 0) {
+                        dir = argv[++i];
+                } else if (strcmp(argv[i], "-t") == 0) {
+                        tokens = strtoull(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-s") == 0) {
+                        seed = strtoull(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-d") == 0) {
+                        depth = strtoull(argv[++i], NULL, 10);
+                } else {
+                        usage(argv[0]);
+                }
+        }
+        if (tokens == 0) {
+                usage(argv[0]);
+        }
+
+        if (strcmp(mode, "gen") == 0 && i == argc) {
+                generate(stdout, tokens, seed, depth);
+                return EXIT_SUCCESS;
+        }
+        if (strcmp(mode, "ref") == 0 && i == argc) {
+                reference(stdin, stdout);
+                return EXIT_SUCCESS;
+        }
+        if (strcmp(mode, "run") == 0 && i + 2 == argc) {
+                return run(dir, tokens, seed, depth, argv[i], argv[i + 1]);
+        }
+
+        usage(argv[0]);
+        return EXIT_FAILURE;
+}
+
+#undef DUMP_EVERY
+#undef MIN_DEPTH
+#undef MAX_DEPTH
@@ -0,0 +1,806 @@
+/*
+ *      umpeep.c
+ *      by Cansu Birsen (cbirse01), Ayse Idil Kolabas (akolab01)
+ *      December 8, 2023
+ *      Assembly Lang RPN
+ *
+ *      Peephole optimizer for assembled .um programs, run by compile -O.
+ *      Splits segment 0 into basic blocks, then within each block removes
+ *      load values that load what the register already holds and writes
+ *      that are overwritten before being read, and retargets jumps whose
+ *      target is itself a jump to the same register.
+ *
+ *      A .um file has no relocation information, and a load value of a
+ *      label cannot be told apart from one of a plain number, so no
+ *      instruction may change address. The instructions a block keeps are
+ *      therefore moved up to its start and the words freed between its
+ *      last instruction and the next block are filled with halts, which
+ *      are never run. Only blocks that end in a load program or a halt
+ *      are rewritten that way, and the file keeps its length.
+ *
+ *      Only words surely run as instructions are rewritten: blocks reached
+ *      from word 0 by jumps to known targets, returns of calls, and the
+ *      targets of dispatch tables. The program must not read or write its
+ *      own instructions as data, which code written by umasm does not.
+ *
+ *      Usage: umpeep [-n] [-z reg] input.um output.um
+ *              -n      only report, do not write output.um
+ *              -z reg  register reg is always 0, as umasm's .zero declares
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+/* opcodes of the UM */
+enum um_opcode {
+        CMOV = 0, SLOAD, SSTORE, ADD, MUL, DIV, NAND,
+        HALT, MAP, UNMAP, OUT, IN, LOADP, LV
+};
+
+/* encoding of the halts that pad the words a block freed */
+#define PAD ((uint32_t)HALT << 28)
+
+/* registers set in a bit mask */
+#define REG(r) (1u << (r))
+#define ALL_REGS 0xffu
+
+/* decoded fields of an instruction */
+static inline unsigned op(uint32_t w)   { return w >> 28; }
+static inline unsigned ra(uint32_t w)   { return (w >> 6) & 7; }
+static inline unsigned rb(uint32_t w)   { return (w >> 3) & 7; }
+static inline unsigned rc(uint32_t w)   { return w & 7; }
+static inline unsigned lv_a(uint32_t w) { return (w >> 25) & 7; }
+static inline uint32_t lv_v(uint32_t w) { return w & 0x1ffffff; }
+
+/* what the optimizer found, for the report */
+typedef struct peep_stats {
+        uint32_t code_words;    /* words reached as instructions */
+        uint32_t blocks;        /* blocks that end in a jump or halt */
+        uint32_t loads;         /* redundant load values removed */
+        uint32_t dead;          /* overwritten writes removed */
+        uint32_t threads;       /* jumps retargeted */
+} peep_stats;
+
+/******************************** writes *********************************
+ *
+ * Returns the registers an instruction always overwrites
+ *
+ * Inputs:
+ *              uint32_t w: the instruction
+ * Return:
+ *              mask of registers
+ * Expects:
+ *              none
+ * Notes:
+ *              a conditional move does not always write, so it is left out
+ *
+ *****************************************************************************/
+static uint32_t writes(uint32_t w)
+{
+        switch (op(w)) {
+        case SLOAD: case ADD: case MUL: case DIV: case NAND:
+                return REG(ra(w));
+        case MAP:
+                return REG(rb(w));
+        case IN:
+                return REG(rc(w));
+        case LV:
+                return REG(lv_a(w));
+        default:
+                return 0;
+        }
+}
+
+/******************************** reads *********************************
+ *
+ * Returns the registers an instruction reads
+ *
+ * Inputs:
+ *              uint32_t w: the instruction
+ * Return:
+ *              mask of registers
+ * Expects:
+ *              none
+ * Notes:
+ *              a conditional move reads A, since A keeps its value when
+ *              the move is not made
+ *
+ *****************************************************************************/
+static uint32_t reads(uint32_t w)
+{
+        switch (op(w)) {
+        case CMOV: case SSTORE:
+                return REG(ra(w)) | REG(rb(w)) | REG(rc(w));
+        case SLOAD: case ADD: case MUL: case DIV: case NAND: case LOADP:
+                return REG(rb(w)) | REG(rc(w));
+        case MAP: case UNMAP: case OUT:
+                return REG(rc(w));
+        default:
+                return 0;
+        }
+}
+
+/* true for instructions that only write a register, so removing one whose
+ * result is never read changes nothing. division is left out as it can fail
+ */
+static bool pure(uint32_t w)
+{
+        unsigned o = op(w);
+        return o == LV || o == ADD || o == MUL || o == NAND;
+}
+
+/******************************** zero_registers *****************************
+ *
+ * Finds the registers no word of the program can make nonzero. Registers
+ * start at 0, so these hold 0 everywhere.
+ *
+ * Inputs:
+ *              const uint32_t *words: the program
+ *              uint32_t n: number of words
+ * Return:
+ *              mask of registers that are always 0
+ * Expects:
+ *              none
+ * Notes:
+ *              every word is decoded, data included, which can only make the
+ *              answer smaller
+ *
+ *****************************************************************************/
+static uint32_t zero_registers(const uint32_t *words, uint32_t n)
+{
+        uint32_t zero = ALL_REGS;
+        bool changed = true;
+
+        while (changed) {
+                changed = false;
+                for (uint32_t i = 0; i < n; i++) {
+                        uint32_t w = words[i];
+                        unsigned a = ra(w), b = rb(w), c = rc(w);
+                        bool zb = zero & REG(b), zc = zero & REG(c);
+                        uint32_t target = writes(w);
+                        bool stays_zero;
+
+                        switch (op(w)) {
+                        case CMOV:
+                                target = REG(a);
+                                stays_zero = a == b || zb || zc;
+                                break;
+                        case ADD:
+                                stays_zero = zb && zc;
+                                break;
+                        case MUL:
+                                stays_zero = zb || zc;
+                                break;
+                        case DIV:
+                                stays_zero = zb;
+                                break;
+                        case LV:
+                                stays_zero = lv_v(w) == 0;
+                                break;
+                        default:
+                                stays_zero = false;
+                                break;
+                        }
+
+                        if ((zero & target) && !stays_zero) {
+                                zero &= ~target;
+                                changed = true;
+                        }
+                }
+        }
+
+        return zero;
+}
+
+/* at most two values a register may hold, enough to follow the two load
+ * values and conditional move an umasm "if ... goto" becomes
+ */
+typedef struct choice {
+        unsigned count;         /* 0 when the value is not known */
+        uint32_t value[2];
+} choice;
+
+/* shortest run of words holding addresses taken to be a dispatch table */
+#define TABLE_RUN 8
+
+/******************************** choice_after *******************************
+ *
+ * Updates the values registers may hold after an instruction runs
+ *
+ * Inputs:
+ *              uint32_t w: the instruction
+ *              choice *regs: the eight registers
+ * Return:
+ *              none
+ * Expects:
+ *              regs to not be null
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static void choice_after(uint32_t w, choice *regs)
+{
+        unsigned a = ra(w), b = rb(w), c = rc(w);
+        bool single = regs[b].count == 1 && regs[c].count == 1;
+        choice result = { 0, { 0, 0 } };
+
+        switch (op(w)) {
+        case LV:
+                regs[lv_a(w)] = (choice){ 1, { lv_v(w), 0 } };
+                return;
+        case ADD:
+                if (single) {
+                        result = (choice){ 1, { regs[b].value[0] +
+                                                regs[c].value[0], 0 } };
+                }
+                break;
+        case MUL:
+                if (single) {
+                        result = (choice){ 1, { regs[b].value[0] *
+                                                regs[c].value[0], 0 } };
+                }
+                break;
+        case NAND:
+                if (single) {
+                        result = (choice){ 1, { ~(regs[b].value[0] &
+                                                  regs[c].value[0]), 0 } };
+                }
+                break;
+        case CMOV:
+                if (a == b || (single && regs[c].value[0] == 0)) {
+                        return;
+                }
+                if (single) {
+                        regs[a] = regs[b];
+                        return;
+                }
+                if (regs[a].count == 1 && regs[b].count == 1) {
+                        result = (choice){ 2, { regs[a].value[0],
+                                                regs[b].value[0] } };
+                }
+                regs[a] = result;
+                return;
+        default:
+                for (unsigned r = 0; r < 8; r++) {
+                        if (writes(w) & REG(r)) {
+                                regs[r] = result;
+                        }
+                }
+                return;
+        }
+
+        regs[a] = result;
+}
+
+/******************************** walk_block *********************************
+ *
+ * Marks the words of the block starting at a word as instructions and
+ * pushes the blocks it can go to
+ *
+ * Inputs:
+ *              const uint32_t *words: the program
+ *              uint32_t n: number of words
+ *              uint32_t zero: registers that are always 0
+ *              uint32_t start: first word of the block
+ *              bool *code: set for each word reached as an instruction
+ *              uint32_t *work: stack of blocks still to walk
+ *              uint32_t *top: number of blocks on work
+ * Return:
+ *              none
+ * Expects:
+ *              work to have room for every word of the program
+ * Notes:
+ *              a load program goes to the values its register may hold when
+ *              the segment register is 0. the word after it is reached when
+ *              the block loads its address, as the return of a call
+ *
+ *****************************************************************************/
+static void walk_block(const uint32_t *words, uint32_t n, uint32_t zero,
+                       uint32_t start, bool *code, uint32_t *work,
+                       uint32_t *top)
+{
+        choice regs[8];
+        for (unsigned r = 0; r < 8; r++) {
+                regs[r] = (choice){ (zero & REG(r)) ? 1 : 0, { 0, 0 } };
+        }
+
+        for (uint32_t pc = start; pc < n && !code[pc] &&
+                                  op(words[pc]) <= LV; pc++) {
+                uint32_t w = words[pc];
+                code[pc] = true;
+
+                if (op(w) == HALT) {
+                        return;
+                }
+                if (op(w) != LOADP) {
+                        choice_after(w, &regs[0]);
+                        continue;
+                }
+
+                if (regs[rb(w)].count == 1 && regs[rb(w)].value[0] == 0) {
+                        for (unsigned i = 0; i < regs[rc(w)].count; i++) {
+                                if (regs[rc(w)].value[i] < n) {
+                                        work[(*top)++] = regs[rc(w)].value[i];
+                                }
+                        }
+                }
+                for (uint32_t i = start; i < pc && pc + 1 < n; i++) {
+                        if (op(words[i]) == LV && lv_v(words[i]) == pc + 1) {
+                                work[(*top)++] = pc + 1;
+                                break;
+                        }
+                }
+                return;
+        }
+}
+
+/******************************** find_code *********************************
+ *
+ * Marks the words run as instructions and the words control can reach other
+ * than by falling through
+ *
+ * Inputs:
+ *              const uint32_t *words: the program
+ *              uint32_t n: number of words
+ *              uint32_t zero: registers that are always 0
+ *              bool *code: set for each word reached as an instruction
+ *              bool *leader: set for each word a jump may land on
+ * Return:
+ *              none
+ * Expects:
+ *              code and leader to hold n cleared entries
+ * Notes:
+ *              code is only what is surely run: blocks reached from word 0
+ *              by jumps to known targets and returns, and blocks named in a
+ *              run of at least TABLE_RUN data words below n that start
+ *              right after a jump or halt, as a dispatch table's targets do.
+ *              leaders are everything a jump might reach: any value below n
+ *              in a load value or in any word may be a label
+ *
+ *****************************************************************************/
+static void find_code(const uint32_t *words, uint32_t n, uint32_t zero,
+                      bool *code, bool *leader)
+{
+        if (n == 0) {
+                return;
+        }
+
+        /* a block pushes at most two targets and a return */
+        uint32_t *work = malloc((3 * n + 1) * sizeof(uint32_t));
+        assert(work != NULL);
+        uint32_t top = 0;
+
+        for (uint32_t i = 0; i < n; i++) {
+                if (words[i] < n) {
+                        leader[words[i]] = true;
+                }
+                if (op(words[i]) == LV && lv_v(words[i]) < n) {
+                        leader[lv_v(words[i])] = true;
+                }
+                if ((op(words[i]) == LOADP || op(words[i]) == HALT) &&
+                    i + 1 < n) {
+                        leader[i + 1] = true;
+                }
+        }
+        leader[0] = true;
+
+        work[top++] = 0;
+        bool changed = true;
+        while (changed) {
+                while (top > 0) {
+                        walk_block(words, n, zero, work[--top], code, work,
+                                   &top);
+                }
+
+                changed = false;
+                for (uint32_t i = 0; i < n;) {
+                        uint32_t run = i;
+                        while (run < n && !code[run] && words[run] < n) {
+                                run++;
+                        }
+                        if (run - i < TABLE_RUN) {
+                                i = run + 1;
+                                continue;
+                        }
+                        for (; i < run; i++) {
+                                uint32_t t = words[i];
+                                if (!code[t] && t > 0 && code[t - 1] &&
+                                    (op(words[t - 1]) == LOADP ||
+                                     op(words[t - 1]) == HALT)) {
+                                        work[top++] = t;
+                                        walk_block(words, n, zero,
+                                                   work[--top], code, work,
+                                                   &top);
+                                        changed = true;
+                                }
+                        }
+                }
+        }
+
+        free(work);
+}
+
+/******************************** known_after *******************************
+ *
+ * Updates what is known of the registers after an instruction runs
+ *
+ * Inputs:
+ *              uint32_t w: the instruction
+ *              uint32_t *known: mask of registers whose value is known
+ *              uint32_t *value: the known values
+ * Return:
+ *              none
+ * Expects:
+ *              known and value to not be null
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static void known_after(uint32_t w, uint32_t *known, uint32_t *value)
+{
+        unsigned a = ra(w), b = rb(w), c = rc(w);
+        bool kb = *known & REG(b), kc = *known & REG(c);
+
+        switch (op(w)) {
+        case LV:
+                *known |= REG(lv_a(w));
+                value[lv_a(w)] = lv_v(w);
+                return;
+        case ADD:
+                if (kb && kc) {
+                        *known |= REG(a);
+                        value[a] = value[b] + value[c];
+                        return;
+                }
+                break;
+        case MUL:
+                if (kb && kc) {
+                        *known |= REG(a);
+                        value[a] = value[b] * value[c];
+                        return;
+                }
+                break;
+        case NAND:
+                if (kb && kc) {
+                        *known |= REG(a);
+                        value[a] = ~(value[b] & value[c]);
+                        return;
+                }
+                break;
+        case CMOV:
+                if (kc && value[c] == 0) {
+                        return;
+                }
+                if (kc && (*known & REG(b))) {
+                        *known |= REG(a);
+                        value[a] = value[b];
+                        return;
+                }
+                if (a == b) {
+                        return;
+                }
+                *known &= ~REG(a);
+                return;
+        default:
+                break;
+        }
+
+        *known &= ~writes(w);
+}
+
+/******************************** thread_jump ********************************
+ *
+ * Retargets a block ending in "load value rX, T; load program 0, rX" when
+ * the word at T starts another such jump through rX, so control goes to
+ * the final target in one jump. rX ends up with the same value either way.
+ *
+ * Inputs:
+ *              uint32_t *kept: the kept instructions of the block
+ *              uint32_t count: number of kept instructions
+ *              const uint32_t *words: the program before any rewrite
+ *              uint32_t n: number of words
+ *              uint32_t zero: registers that are always 0
+ * Return:
+ *              true if the block was retargeted
+ * Expects:
+ *              the last kept instruction to be a load program
+ * Notes:
+ *              a chain of jumps is followed, stopping at a loop
+ *
+ *****************************************************************************/
+static bool thread_jump(uint32_t *kept, uint32_t count, const uint32_t *words,
+                        uint32_t n, uint32_t zero)
+{
+        if (count < 2) {
+                return false;
+        }
+
+        uint32_t jump = kept[count - 1], load = kept[count - 2];
+        if (op(load) != LV || lv_a(load) != rc(jump) ||
+            !(zero & REG(rb(jump)))) {
+                return false;
+        }
+
+        unsigned reg = rc(jump);
+        uint32_t target = lv_v(load);
+        uint32_t hops = 0;
+
+        /* follows jumps that load reg and jump through it */
+        while (target + 1 < n && hops++ < n) {
+                uint32_t next_load = words[target];
+                uint32_t next_jump = words[target + 1];
+                if (op(next_load) != LV || lv_a(next_load) != reg ||
+                    op(next_jump) != LOADP || rc(next_jump) != reg ||
+                    !(zero & REG(rb(next_jump))) ||
+                    lv_v(next_load) == target) {
+                        break;
+                }
+                target = lv_v(next_load);
+        }
+
+        if (target == lv_v(load)) {
+                return false;
+        }
+
+        kept[count - 2] = ((uint32_t)LV << 28) | (reg << 25) | target;
+        return true;
+}
+
+/******************************** optimize_block *****************************
+ *
+ * Removes redundant and dead instructions from one block ending in a load
+ * program or halt, and retargets its jump if it can
+ *
+ * Inputs:
+ *              uint32_t *words: the program
+ *              const uint32_t *original: the program before any rewrite
+ *              uint32_t n: number of words
+ *              uint32_t start: first word of the block
+ *              uint32_t end: the load program or halt ending the block
+ *              uint32_t zero: registers that are always 0
+ *              peep_stats *stats: counts to update
+ * Return:
+ *              none
+ * Expects:
+ *              no word after start up to end to be a jump target
+ * Notes:
+ *              the kept instructions are moved to start and the words after
+ *              them up to end become halts
+ *
+ *****************************************************************************/
+static void optimize_block(uint32_t *words, const uint32_t *original,
+                           uint32_t n, uint32_t start, uint32_t end,
+                           uint32_t zero, peep_stats *stats)
+{
+        uint32_t length = end - start + 1;
+        uint32_t *kept = malloc(length * sizeof(uint32_t));
+        assert(kept != NULL);
+        memcpy(kept, &words[start], length * sizeof(uint32_t));
+        uint32_t count = length;
+
+        bool changed = true;
+        while (changed) {
+                changed = false;
+
+                /* forward: load values of a value the register holds */
+                uint32_t known = zero, value[8] = { 0 };
+                uint32_t out = 0;
+                for (uint32_t i = 0; i < count; i++) {
+                        uint32_t w = kept[i];
+                        if (op(w) == LV && (known & REG(lv_a(w))) &&
+                            value[lv_a(w)] == lv_v(w)) {
+                                stats->loads++;
+                                changed = true;
+                                continue;
+                        }
+                        known_after(w, &known, value);
+                        kept[out++] = w;
+                }
+                count = out;
+
+                /* backward: writes overwritten before any read. every
+                 * register is live when the block ends
+                 */
+                uint32_t live = ALL_REGS;
+                bool *drop = calloc(count, sizeof(bool));
+                assert(drop != NULL);
+                for (uint32_t i = count; i-- > 0;) {
+                        uint32_t w = kept[i];
+                        if (pure(w) && !(live & writes(w))) {
+                                drop[i] = true;
+                                stats->dead++;
+                                changed = true;
+                                continue;
+                        }
+                        live = (live & ~writes(w)) | reads(w);
+                }
+                out = 0;
+                for (uint32_t i = 0; i < count; i++) {
+                        if (!drop[i]) {
+                                kept[out++] = kept[i];
+                        }
+                }
+                count = out;
+                free(drop);
+        }
+
+        if (op(kept[count - 1]) == LOADP &&
+            thread_jump(kept, count, original, n, zero)) {
+                stats->threads++;
+        }
+
+        memcpy(&words[start], kept, count * sizeof(uint32_t));
+        for (uint32_t i = start + count; i <= end; i++) {
+                words[i] = PAD;
+        }
+        free(kept);
+}
+
+/******************************** read_program *******************************
+ *
+ * Reads the big-endian words of a .um file
+ *
+ * Inputs:
+ *              const char *path: the file
+ *              uint32_t *n: where the number of words is stored
+ * Return:
+ *              the words, which the caller frees
+ * Expects:
+ *              the file to be readable and a whole number of words long
+ * Notes:
+ *              exits with EXIT_FAILURE if expectations fail
+ *
+ *****************************************************************************/
+static uint32_t *read_program(const char *path, uint32_t *n)
+{
+        FILE *fp = fopen(path, "rb");
+        if (fp == NULL) {
+                fprintf(stderr, "umpeep: could not open %s\n", path);
+                exit(EXIT_FAILURE);
+        }
+
+        uint32_t capacity = 1024, length = 0;
+        uint32_t *words = malloc(capacity * sizeof(uint32_t));
+        assert(words != NULL);
+
+        unsigned char bytes[4];
+        size_t got;
+        while ((got = fread(bytes, 1, 4, fp)) == 4) {
+                if (length == capacity) {
+                        capacity *= 2;
+                        words = realloc(words, capacity * sizeof(uint32_t));
+                        assert(words != NULL);
+                }
+                words[length++] = (uint32_t)bytes[0] << 24 |
+                                  (uint32_t)bytes[1] << 16 |
+                                  (uint32_t)bytes[2] << 8 | bytes[3];
+        }
+        fclose(fp);
+
+        if (got != 0) {
+                fprintf(stderr, "umpeep: %s is not a whole number of "
+                                "words\n", path);
+                exit(EXIT_FAILURE);
+        }
+
+        *n = length;
+        return words;
+}
+
+/******************************** write_program ******************************
+ *
+ * Writes words to a .um file, big-endian
+ *
+ * Inputs:
+ *              const char *path: the file
+ *              const uint32_t *words: the program
+ *              uint32_t n: number of words
+ * Return:
+ *              none
+ * Expects:
+ *              the file to be writable
+ * Notes:
+ *              exits with EXIT_FAILURE if expectation fails
+ *
+ *****************************************************************************/
+static void write_program(const char *path, const uint32_t *words, uint32_t n)
+{
+        FILE *fp = fopen(path, "wb");
+        if (fp == NULL) {
+                fprintf(stderr, "umpeep: could not open %s\n", path);
+                exit(EXIT_FAILURE);
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+                putc(words[i] >> 24, fp);
+                putc(words[i] >> 16 & 0xff, fp);
+                putc(words[i] >> 8 & 0xff, fp);
+                putc(words[i] & 0xff, fp);
+        }
+        fclose(fp);
+}
+
+int main(int argc, char *argv[])
+{
+        bool dry_run = false;
+        uint32_t declared = 0;
+        int i = 1;
+        for (; i < argc - 2; i++) {
+                if (strcmp(argv[i], "-n") == 0) {
+                        dry_run = true;
+                } else if (strcmp(argv[i], "-z") == 0 && i + 1 < argc - 2 &&
+                           argv[i + 1][0] >= '0' && argv[i + 1][0] <= '7' &&
+                           argv[i + 1][1] == '\0') {
+                        declared |= REG(argv[++i][0] - '0');
+                } else {
+                        break;
+                }
+        }
+        if (i != argc - 2) {
+                fprintf(stderr, "Usage: %s [-n] [-z reg] input.um "
+                                "output.um\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+        const char *input = argv[argc - 2], *output = argv[argc - 1];
+
+        uint32_t n;
+        uint32_t *words = read_program(input, &n);
+        uint32_t *original = malloc((n + 1) * sizeof(uint32_t));
+        bool *code = calloc(n + 1, sizeof(bool));
+        bool *leader = calloc(n + 1, sizeof(bool));
+        assert(original != NULL && code != NULL && leader != NULL);
+        memcpy(original, words, n * sizeof(uint32_t));
+
+        uint32_t zero = zero_registers(words, n) | declared;
+        find_code(words, n, zero, code, leader);
+
+        peep_stats stats = { 0, 0, 0, 0, 0 };
+        uint32_t pc = 0;
+        while (pc < n) {
+                if (!code[pc]) {
+                        pc++;
+                        continue;
+                }
+
+                /* a block runs to a jump or halt, or up to the next leader */
+                uint32_t start = pc;
+                while (op(words[pc]) != LOADP && op(words[pc]) != HALT &&
+                       pc + 1 < n && code[pc + 1] && !leader[pc + 1]) {
+                        pc++;
+                }
+                stats.code_words += pc - start + 1;
+
+                if (op(words[pc]) == LOADP || op(words[pc]) == HALT) {
+                        stats.blocks++;
+                        optimize_block(words, original, n, start, pc, zero,
+                                       &stats);
+                }
+                pc++;
+        }
+
+        fprintf(stderr, "umpeep: %u words, %u as instructions in %u blocks "
+                        "ending in a jump or halt\n",
+                n, stats.code_words, stats.blocks);
+        fprintf(stderr, "umpeep: removed %u redundant load values and %u "
+                        "overwritten writes, threaded %u jumps\n",
+                stats.loads, stats.dead, stats.threads);
+
+        if (!dry_run) {
+                write_program(output, words, n);
+        }
+
+        free(words);
+        free(original);
+        free(code);
+        free(leader);
+        return EXIT_SUCCESS;
+}
+
+#undef PAD
+#undef REG
+#undef ALL_REGS
+#undef TABLE_RUN
@@ -13,6 +13,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
 
 /* CS40 Libraries */
 #include <bitpack.h>
@@ -44,9 +46,145 @@ Except_T Word_Bounds = { "Index Out Of Bounds" };
 /* Raised when the trying to unmap an unmapped segment or segment zero */
 Except_T Faulty_Unmap = { "Refers to Unmapped Segment or Segment Zero" };
 
+/* Raised when the symbol map given with --symbols cannot be read */
+Except_T Bad_Symbols = { "Cannot Read Symbol Map" };
+
+/* command line options selecting the interpreter and its instrumentation */
+typedef struct um_options {
+        bool local_regs;
+        bool trace;
+        bool profile;
+        const char *symbols;
+} um_options;
+
+/* a backward jump target becomes a trace head after this many jumps */
+#define TRACE_HOT_THRESHOLD 64
+
+/* recordings longer than this are abandoned */
+#define TRACE_MAX_LENGTH 1024
+
+/* a head that failed to record this many times is never tried again */
+#define TRACE_MAX_TRIES 3
+
+/* a trace entered this often that completes a loop on fewer than half of
+ * its entries costs more to enter and leave than it saves, so it is retired
+ */
+#define TRACE_MIN_ENTRIES 256
+
+/* why a running trace handed control back to the interpreter */
+enum trace_exit {
+        EXIT_CMOV_GUARD,        /* a branch deciding cmov went the other way */
+        EXIT_JUMP_GUARD,        /* a jump target or segment differed */
+        EXIT_CODE_WRITE,        /* a store changed a traced word */
+        EXIT_COUNT
+};
+
+/* why a recording was abandoned */
+enum trace_abort {
+        ABORT_TOO_LONG,
+        ABORT_HALT,
+        ABORT_PROGRAM_LOAD,
+        ABORT_CODE_WRITE,
+        ABORT_COUNT
+};
+
+/* one decoded instruction of a trace. for cmov, value records whether the
+ * move happened while recording; for a jump, the target it went to
+ */
+typedef struct trace_inst {
+        uint32_t pc;
+        uint32_t value;
+        uint8_t op;
+        uint8_t a;
+        uint8_t b;
+        uint8_t c;
+        bool guard;
+} trace_inst;
+
+/* a recorded loop starting at head, with its statistics */
+typedef struct trace_T {
+        uint32_t head;
+        int length;
+        trace_inst *insts;
+        bool live;
+        bool profile;
+        uint64_t entries;
+        uint64_t loops;
+        uint64_t executed;
+        uint64_t exits[EXIT_COUNT];
+} *trace_T;
+
+/* per address tables for segment 0 and the traces built over it */
+typedef struct trace_state {
+        uint32_t length;
+        uint32_t *hot;
+        uint8_t *tries;
+        uint8_t *covered;
+        trace_T *trace_at;
+        Seq_T traces;
+        trace_T recording;
+        uint64_t aborts[ABORT_COUNT];
+        uint64_t flushes;
+        uint64_t retired;
+        uint64_t counts[16];
+} trace_state;
+
+/* marks a word of segment 0 that comes before every label */
+#define NO_SYMBOL UINT32_MAX
+
+/* a label of segment 0 from the symbol map and what ran under it */
+typedef struct symbol_T {
+        char *name;
+        uint32_t offset;
+        uint64_t self;          /* instructions run from the label on */
+        uint64_t calls;         /* jumps to it with r1 holding the return */
+        uint64_t inclusive;     /* instructions run until the calls return */
+        uint64_t entered;       /* instruction count at the outermost call */
+        uint32_t depth;         /* calls not yet returned */
+} *symbol_T;
+
+/* a call not yet returned: the label called and where it returns to */
+typedef struct call_frame {
+        uint32_t symbol;
+        uint32_t ret;
+} call_frame;
+
+/* per label counts for --symbols, following the linking r1 convention */
+typedef struct symbol_profile {
+        symbol_T *symbols;      /* sorted by offset */
+        int num_symbols;
+        uint32_t *symbol_at;    /* label covering each word of segment 0 */
+        uint32_t length;
+        call_frame *stack;
+        int depth;
+        int capacity;
+        uint64_t executed;
+        uint64_t unattributed;  /* before any label or in a loaded program */
+        bool replaced;
+} symbol_profile;
+
 /* Helper Function Declarations */
-static inline void initiate_program(FILE *fp);
+static inline void initiate_program(FILE *fp, um_options opts);
 static inline void word_interpreter(Seq_T mem, uint32_t *registers, Seq_T id_m);
+static inline void register_interpreter(Seq_T mem, Seq_T id_m);
+static inline void trace_interpreter(Seq_T mem, Seq_T id_m, um_options opts);
+static inline uint32_t run_trace(trace_T t, uint32_t *reg, Seq_T mem, Seq_T id_m, trace_state *st, int *reason);
+static inline trace_inst *trace_append(trace_state *st, uint32_t pc, uint32_t op, uint32_t a, uint32_t b, uint32_t c, uint32_t value);
+static inline bool trace_records(trace_T t, uint32_t pc);
+static inline void trace_begin(trace_state *st, uint32_t head);
+static inline void trace_close(trace_state *st);
+static inline void trace_abort(trace_state *st, int reason);
+static inline void trace_retire(trace_state *st, trace_T t);
+static inline void trace_flush(trace_state *st);
+static inline void trace_reset(trace_state *st, uint32_t length);
+static inline void trace_profile(trace_state *st, bool traced);
+static inline void trace_free(trace_state *st);
+static inline symbol_profile *symbol_load(const char *path, uint32_t length);
+static inline void symbol_count(symbol_profile *sp, uint32_t pc);
+static inline void symbol_jump(symbol_profile *sp, uint32_t pc, uint32_t target, uint32_t r1);
+static inline void symbol_return(symbol_profile *sp);
+static inline void symbol_report(symbol_profile *sp);
+static inline void symbol_free(symbol_profile *sp);
 static inline void conditional_move(int reg_a, int reg_b, int reg_c, uint32_t *reg);
 static inline void segmented_load(int reg_a, int reg_b, int reg_c, Seq_T mem, uint32_t *reg);
 static inline void segmented_store(int reg_a, int reg_b, int reg_c, Seq_T mem, uint32_t *reg);
@@ -60,7 +198,15 @@ static inline void output(int reg_c, uint32_t *reg);
 static inline void input(int reg_c, uint32_t *reg);
 static inline int load_program(int reg_b, int reg_c, Seq_T mem, uint32_t *reg);
 static inline void load_value(int reg_a, int val, uint32_t *reg);
+static inline uint32_t load_word(Seq_T mem, uint32_t seg_id, uint32_t offset);
+static inline void store_word(Seq_T mem, uint32_t seg_id, uint32_t offset, uint32_t value);
+static inline uint32_t map_words(Seq_T mem, Seq_T id_m, uint32_t num_words);
+static inline void unmap_id(Seq_T mem, Seq_T id_m, uint32_t seg_id);
+static inline void output_value(uint32_t val);
+static inline uint32_t input_value(void);
+static inline void duplicate_program(Seq_T mem, uint32_t seg_id);
 static inline FILE *open_or_die(int argc, char *argv[]);
+static inline bool parse_options(int *argc, char **argv[], um_options *opts);
 
 /* segment struct representing each segment in memory and its length */
 typedef struct segment_T *segment_T;
@@ -70,6 +216,12 @@ struct segment_T {
 };
 
 int main(int argc, char *argv[]) {
+        /* flags before the file name select the interpreter */
+        um_options opts = { false, false, false, NULL };
+        if (!parse_options(&argc, &argv, &opts)) {
+                return EXIT_FAILURE;
+        }
+
         /* open input file */
         FILE *fp = open_or_die(argc, argv);
         if (fp == NULL) {
@@ -77,12 +229,46 @@ int main(int argc, char *argv[]) {
         }
 
         /* Calls operations module to implement the instructions */
-        initiate_program(fp);
+        initiate_program(fp, opts);
 
         fclose(fp);
         return 0;
 }
 
+static inline bool parse_options(int *argc, char **argv[], um_options *opts)
+{
+        /* consume every "--" flag that precedes the file name */
+        while (*argc > 2 && strncmp((*argv)[1], "--", 2) == 0) {
+                char *flag = (*argv)[1];
+                if (strcmp(flag, "--local-regs") == 0) {
+                        opts->local_regs = true;
+                } else if (strcmp(flag, "--trace") == 0) {
+                        opts->trace = true;
+                } else if (strcmp(flag, "--profile") == 0) {
+                        opts->profile = true;
+                } else if (strcmp(flag, "--symbols") == 0 && *argc > 3) {
+                        /* the map is the next argument */
+                        opts->symbols = (*argv)[2];
+                        opts->profile = true;
+                        (*argc)--;
+                        (*argv)++;
+                } else {
+                        fprintf(stderr, "Unknown option %s.\n", flag);
+                        return false;
+                }
+                (*argc)--;
+                (*argv)++;
+        }
+
+        /* counts inside traces are not kept per word */
+        if (opts->symbols != NULL && opts->trace) {
+                fprintf(stderr, "--symbols cannot be used with --trace.\n");
+                return false;
+        }
+
+        return true;
+}
+
 static inline FILE *open_or_die(int argc, char *argv[]) {   
         /* check if correct number of arguments is supplied */
         if (argc != 2) {
@@ -96,7 +282,7 @@ static inline FILE *open_or_die(int argc, char *argv[]) {
         return fp;
 }
 
-static inline void initiate_program(FILE *fp)
+static inline void initiate_program(FILE *fp, um_options opts)
 {
         assert(fp != NULL);
 
@@ -163,8 +349,14 @@ static inline void initiate_program(FILE *fp)
                 registers[i] = (uint32_t)0;
         }
 
-        /* all program info is sent to helper function */
-        word_interpreter(mem, registers, id_m);
+        /* all program info is sent to the selected interpreter */
+        if (opts.trace || opts.profile) {
+                trace_interpreter(mem, id_m, opts);
+        } else if (opts.local_regs) {
+                register_interpreter(mem, id_m);
+        } else {
+                word_interpreter(mem, registers, id_m);
+        }
         
         /* frees all allocated space */
         
@@ -175,9 +367,7 @@ static inline void initiate_program(FILE *fp)
         for (int i = 0; i < lengthmem; i++) {
                 segment_T segment = Seq_remlo(mem);
                 /* frees non-null segments */
-                if (segment->length != 0) {
-                        free(segment->seg_arr);  
-                }
+                free(segment->seg_arr);
                 FREE(segment);
         }
 
@@ -314,83 +504,894 @@ static inline void word_interpreter(Seq_T mem, uint32_t *reg, Seq_T id_m)
         }
 }
 
-static inline void conditional_move(int reg_a, int reg_b, int reg_c, uint32_t *reg)
+static inline void register_interpreter(Seq_T mem, Seq_T id_m)
 {
-        assert(reg != NULL);
+        assert(mem != NULL);
+        assert(id_m != NULL);
 
-        if (reg_c >=  8 || reg_c < 0 || reg_b >=  8 || reg_b < 0 || reg_a >=  8 || reg_a < 0) {
+        /* get the segment 0 for program */
+        if (0 >= Seq_length(mem)) {
                 RAISE(Word_Bounds);
         }
 
-        if (reg[reg_c] != 0) {
-                reg[reg_a] = reg[reg_b];
+        segment_T program_T = Seq_get(mem, 0);
+        uint32_t *program = program_T->seg_arr;
+
+        /* get number of words in running program, segment 0 */
+        uint32_t length_p = program_T->length;
+
+        /* the register file is local and its address never escapes, so the
+         * compiler knows stores to segments cannot change it; it is still
+         * indexed by register fields decoded at run time, so it stays in
+         * memory and each operand is an L1 load, as with the pointer
+         */
+        uint32_t reg[8] = { 0 };
+
+        uint32_t p_counter = 0;
+        while (p_counter < length_p) {
+                uint32_t curr_word = program[p_counter++];
+                uint32_t op = curr_word >> 28;
+
+                /* load value has its own register field and a 25-bit value */
+                if (op == 13) {
+                        reg[(curr_word >> 25) & 0x7] = curr_word & 0x1FFFFFF;
+                        continue;
+                }
+
+                /* operands are read once, before the handler runs */
+                uint32_t *ra = &reg[(curr_word >> 6) & 0x7];
+                uint32_t *rb = &reg[(curr_word >> 3) & 0x7];
+                uint32_t *rc = &reg[curr_word & 0x7];
+                uint32_t val_b = *rb;
+                uint32_t val_c = *rc;
+
+                switch (op) {
+                        case 0:
+                                if (val_c != 0) {
+                                        *ra = val_b;
+                                }
+                                break;
+                        case 1:
+                                *ra = load_word(mem, val_b, val_c);
+                                break;
+                        case 2:
+                                store_word(mem, *ra, val_b, val_c);
+                                break;
+                        case 3:
+                                *ra = val_b + val_c;
+                                break;
+                        case 4:
+                                *ra = val_b * val_c;
+                                break;
+                        case 5:
+                                /* URE if divisor is 0 */
+                                if (val_c == 0) {
+                                        RAISE(Division_Zero);
+                                }
+                                *ra = val_b / val_c;
+                                break;
+                        case 6:
+                                *ra = ~(val_b & val_c);
+                                break;
+                        case 7:
+                                /* halt ends the program */
+                                return;
+                        case 8:
+                                *rb = map_words(mem, id_m, val_c);
+                                break;
+                        case 9:
+                                unmap_id(mem, id_m, val_c);
+                                break;
+                        case 10:
+                                output_value(val_c);
+                                break;
+                        case 11:
+                                *rc = input_value();
+                                break;
+                        case 12:
+                                /* update program and prog length if a new
+                                 * segment was loaded, then jump
+                                 */
+                                if (val_b != 0) {
+                                        duplicate_program(mem, val_b);
+                                        program_T = Seq_get(mem, 0);
+                                        program = program_T->seg_arr;
+                                        length_p = program_T->length;
+                                }
+                                p_counter = val_c;
+                                break;
+                        default:
+                                /* unrecognized instruction */
+                                RAISE(Not_Recognized);
+                }
         }
+
+        /* program counter ran off the end without a halt */
+        RAISE(Counter_Bounds);
 }
 
-static inline void segmented_load(int reg_a, int reg_b, int reg_c, Seq_T mem, uint32_t *reg)
+static inline void trace_interpreter(Seq_T mem, Seq_T id_m, um_options opts)
 {
         assert(mem != NULL);
-        assert(reg != NULL);
+        assert(id_m != NULL);
 
-        if (reg_c >=  8 || reg_c < 0 || reg_b >=  8 || reg_b < 0 || reg_a >=  8 || reg_a < 0) {
+        /* get the segment 0 for program */
+        if (0 >= Seq_length(mem)) {
                 RAISE(Word_Bounds);
         }
 
-        /* Retrieve the segment and word indices */
-        uint32_t segment_id = reg[reg_b];
-        int word_id = reg[reg_c];
+        segment_T program_T = Seq_get(mem, 0);
+        uint32_t *program = program_T->seg_arr;
 
-        /* check for requirements */
-        if (segment_id >= (uint32_t)Seq_length(mem)) {
-                RAISE(Word_Bounds);
+        /* get number of words in running program, segment 0 */
+        uint32_t length_p = program_T->length;
+
+        trace_state st;
+        memset(&st, 0, sizeof(st));
+        st.traces = Seq_new(100);
+        assert(st.traces != NULL);
+        trace_reset(&st, length_p);
+
+        uint32_t reg[8] = { 0 };
+
+        /* per label counts, only with --symbols */
+        symbol_profile *sp = NULL;
+        if (opts.symbols != NULL) {
+                sp = symbol_load(opts.symbols, length_p);
         }
 
-        segment_T seg_T = Seq_get(mem, segment_id);
-        uint32_t *seg = seg_T->seg_arr;
+        /* halt being called at the end of the program to be checked later */
+        bool halt_called = false;
 
-        /* check for requirements */
-        if (seg == NULL) {
-                RAISE(Segment_Unmapped);
+        uint32_t p_counter = 0;
+        while (p_counter < length_p) {
+                uint32_t pc = p_counter++;
+                uint32_t curr_word = program[pc];
+                uint32_t op = curr_word >> 28;
+                uint32_t a, b, c, value = 0;
+
+                if (opts.profile) {
+                        st.counts[op]++;
+                        if (sp != NULL) {
+                                symbol_count(sp, pc);
+                        }
+                }
+
+                /* load value has its own register field and a 25-bit value */
+                if (op == 13) {
+                        a = (curr_word >> 25) & 0x7;
+                        b = 0;
+                        c = 0;
+                        value = curr_word & 0x1FFFFFF;
+                } else {
+                        a = (curr_word >> 6) & 0x7;
+                        b = (curr_word >> 3) & 0x7;
+                        c = curr_word & 0x7;
+                }
+
+                /* instructions are recorded before they run */
+                trace_inst *rec = NULL;
+                if (st.recording != NULL) {
+                        rec = trace_append(&st, pc, op, a, b, c, value);
+                }
+
+                uint32_t val_b = reg[b];
+                uint32_t val_c = reg[c];
+
+                switch (op) {
+                        case 0:
+                                if (rec != NULL) {
+                                        rec->value = (val_c != 0);
+                                }
+                                if (val_c != 0) {
+                                        reg[a] = val_b;
+                                }
+                                break;
+                        case 1:
+                                reg[a] = load_word(mem, val_b, val_c);
+                                break;
+                        case 2:
+                                store_word(mem, reg[a], val_b, val_c);
+
+                                /* code writes invalidate what was traced */
+                                if (reg[a] == 0) {
+                                        if (st.recording != NULL &&
+                                            trace_records(st.recording,
+                                                          val_b)) {
+                                                trace_abort(&st,
+                                                            ABORT_CODE_WRITE);
+                                        }
+                                        if (st.covered[val_b]) {
+                                                trace_flush(&st);
+                                        }
+                                }
+                                break;
+                        case 3:
+                                reg[a] = val_b + val_c;
+                                break;
+                        case 4:
+                                reg[a] = val_b * val_c;
+                                break;
+                        case 5:
+                                /* URE if divisor is 0 */
+                                if (val_c == 0) {
+                                        RAISE(Division_Zero);
+                                }
+                                reg[a] = val_b / val_c;
+                                break;
+                        case 6:
+                                reg[a] = ~(val_b & val_c);
+                                break;
+                        case 7:
+                                /* jumps to the end of the program */
+                                if (st.recording != NULL) {
+                                        trace_abort(&st, ABORT_HALT);
+                                }
+                                p_counter = length_p;
+                                halt_called = true;
+                                break;
+                        case 8:
+                                reg[b] = map_words(mem, id_m, val_c);
+                                break;
+                        case 9:
+                                unmap_id(mem, id_m, val_c);
+                                break;
+                        case 10:
+                                output_value(val_c);
+                                break;
+                        case 11:
+                                reg[c] = input_value();
+                                break;
+                        case 12:
+                                if (val_b != 0) {
+                                        /* a new program makes every table
+                                         * and trace stale
+                                         */
+                                        if (st.recording != NULL) {
+                                                trace_abort(&st,
+                                                        ABORT_PROGRAM_LOAD);
+                                        }
+                                        duplicate_program(mem, val_b);
+                                        program_T = Seq_get(mem, 0);
+                                        program = program_T->seg_arr;
+                                        length_p = program_T->length;
+                                        trace_flush(&st);
+                                        trace_reset(&st, length_p);
+                                        p_counter = val_c;
+
+                                        /* the labels no longer apply */
+                                        if (sp != NULL) {
+                                                sp->replaced = true;
+                                        }
+                                        break;
+                                }
+
+                                if (sp != NULL) {
+                                        symbol_jump(sp, pc, val_c, reg[1]);
+                                }
+                                p_counter = val_c;
+                                if (rec != NULL) {
+                                        rec->value = val_c;
+                                        if (val_c == st.recording->head) {
+                                                trace_close(&st);
+                                        }
+                                }
+                                if (!opts.trace || val_c >= length_p ||
+                                    st.recording != NULL) {
+                                        break;
+                                }
+
+                                /* enter a trace at its head, otherwise
+                                 * count backward jumps to find new heads
+                                 */
+                                if (st.trace_at[val_c] != NULL) {
+                                        int reason;
+                                        trace_T t = st.trace_at[val_c];
+                                        p_counter = run_trace(t, reg, mem,
+                                                              id_m, &st,
+                                                              &reason);
+                                        if (reason == EXIT_CODE_WRITE) {
+                                                trace_flush(&st);
+                                        } else if (t->entries >=
+                                                   TRACE_MIN_ENTRIES &&
+                                                   t->loops * 2 <
+                                                   t->entries) {
+                                                trace_retire(&st, t);
+                                        }
+                                } else if (val_c <= pc &&
+                                           st.hot[val_c] != UINT32_MAX &&
+                                           ++st.hot[val_c] >=
+                                           TRACE_HOT_THRESHOLD) {
+                                        trace_begin(&st, val_c);
+                                        st.recording->profile = opts.profile;
+                                }
+                                break;
+                        case 13:
+                                reg[a] = value;
+                                break;
+                        default:
+                                /* unrecognized instruction */
+                                RAISE(Not_Recognized);
+                }
+
+                if (st.recording != NULL &&
+                    st.recording->length >= TRACE_MAX_LENGTH) {
+                        trace_abort(&st, ABORT_TOO_LONG);
+                }
         }
-        if (word_id >= seg_T->length) {
-                RAISE(Word_Bounds);
+
+        if (opts.profile) {
+                trace_profile(&st, opts.trace);
+        }
+        if (sp != NULL) {
+                symbol_report(sp);
+                symbol_free(sp);
+        }
+        trace_free(&st);
+
+        /* raise exception if halt was not called */
+        if (!halt_called) {
+                RAISE(Counter_Bounds);
+        }
+}
+
+static inline uint32_t run_trace(trace_T t, uint32_t *reg, Seq_T mem,
+                                 Seq_T id_m, trace_state *st, int *reason)
+{
+        trace_inst *insts = t->insts;
+        int length = t->length;
+        uint64_t loops = 0;
+        uint32_t resume = t->head;
+        int i = 0;
+
+        t->entries++;
+
+        /* the trace repeats until a guard fails. the instruction that fails
+         * a guard has not run yet, so the interpreter resumes at it
+         */
+        for (;;) {
+                for (i = 0; i < length; i++) {
+                        trace_inst *in = &insts[i];
+                        uint32_t val_b = reg[in->b];
+                        uint32_t val_c = reg[in->c];
+
+                        if (t->profile) {
+                                st->counts[in->op]++;
+                        }
+
+                        switch (in->op) {
+                                case 0:
+                                        if (in->guard) {
+                                                if ((val_c != 0) !=
+                                                    in->value) {
+                                                        *reason =
+                                                          EXIT_CMOV_GUARD;
+                                                        resume = in->pc;
+                                                        goto done;
+                                                }
+                                                if (in->value) {
+                                                        reg[in->a] = val_b;
+                                                }
+                                        } else {
+                                                /* branch free select */
+                                                uint32_t mask =
+                                                        -(uint32_t)(val_c != 0);
+                                                reg[in->a] = (val_b & mask) |
+                                                        (reg[in->a] & ~mask);
+                                        }
+                                        break;
+                                case 1:
+                                        reg[in->a] = load_word(mem, val_b,
+                                                               val_c);
+                                        break;
+                                case 2:
+                                        store_word(mem, reg[in->a], val_b,
+                                                   val_c);
+                                        if (reg[in->a] == 0 &&
+                                            st->covered[val_b]) {
+                                                *reason = EXIT_CODE_WRITE;
+                                                resume = in->pc + 1;
+                                                i++;
+                                                goto done;
+                                        }
+                                        break;
+                                case 3:
+                                        reg[in->a] = val_b + val_c;
+                                        break;
+                                case 4:
+                                        reg[in->a] = val_b * val_c;
+                                        break;
+                                case 5:
+                                        /* URE if divisor is 0 */
+                                        if (val_c == 0) {
+                                                RAISE(Division_Zero);
+                                        }
+                                        reg[in->a] = val_b / val_c;
+                                        break;
+                                case 6:
+                                        reg[in->a] = ~(val_b & val_c);
+                                        break;
+                                case 8:
+                                        reg[in->b] = map_words(mem, id_m,
+                                                               val_c);
+                                        break;
+                                case 9:
+                                        unmap_id(mem, id_m, val_c);
+                                        break;
+                                case 10:
+                                        output_value(val_c);
+                                        break;
+                                case 11:
+                                        reg[in->c] = input_value();
+                                        break;
+                                case 12:
+                                        if (val_b != 0 || val_c != in->value) {
+                                                *reason = EXIT_JUMP_GUARD;
+                                                resume = in->pc;
+                                                goto done;
+                                        }
+                                        break;
+                                case 13:
+                                        reg[in->a] = in->value;
+                                        break;
+                        }
+                }
+                loops++;
         }
 
-        reg[reg_a] = seg[word_id];
+done:
+        /* the instruction that failed its guard is counted again by the
+         * interpreter, so it is taken back out here
+         */
+        if (t->profile && *reason != EXIT_CODE_WRITE) {
+                st->counts[insts[i].op]--;
+        }
+        t->loops += loops;
+        t->executed += loops * length + i;
+        t->exits[*reason]++;
+
+        return resume;
 }
 
-static inline void segmented_store(int reg_a, int reg_b, int reg_c, Seq_T mem, uint32_t *reg)
+static inline trace_inst *trace_append(trace_state *st, uint32_t pc,
+                                       uint32_t op, uint32_t a, uint32_t b,
+                                       uint32_t c, uint32_t value)
+{
+        trace_T t = st->recording;
+        trace_inst *in = &t->insts[t->length++];
+
+        in->pc = pc;
+        in->op = op;
+        in->a = a;
+        in->b = b;
+        in->c = c;
+        in->value = value;
+        in->guard = false;
+
+        /* the cmov that last wrote a jump's target register decides the
+         * branch, so it is checked instead of executed blindly
+         */
+        if (op == 12) {
+                for (int i = t->length - 2; i >= 0; i--) {
+                        trace_inst *w = &t->insts[i];
+                        bool writes_c = ((w->op <= 6 && w->op != 2) ||
+                                         w->op == 13) ? w->a == c :
+                                        (w->op == 8) ? w->b == c :
+                                        (w->op == 11) ? w->c == c : false;
+                        if (writes_c) {
+                                w->guard = (w->op == 0);
+                                break;
+                        }
+                }
+        }
+
+        return in;
+}
+
+static inline bool trace_records(trace_T t, uint32_t pc)
+{
+        for (int i = 0; i < t->length; i++) {
+                if (t->insts[i].pc == pc) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+static inline void trace_begin(trace_state *st, uint32_t head)
+{
+        trace_T t;
+        NEW(t);
+        assert(t != NULL);
+        memset(t, 0, sizeof(*t));
+
+        t->head = head;
+        t->insts = malloc(TRACE_MAX_LENGTH * sizeof(trace_inst));
+        assert(t->insts != NULL);
+
+        st->recording = t;
+}
+
+static inline void trace_close(trace_state *st)
+{
+        trace_T t = st->recording;
+        st->recording = NULL;
+
+        t->insts = realloc(t->insts, t->length * sizeof(trace_inst));
+        assert(t->insts != NULL);
+        t->live = true;
+
+        /* stores to any of these words must drop the trace */
+        for (int i = 0; i < t->length; i++) {
+                st->covered[t->insts[i].pc] = 1;
+        }
+        st->trace_at[t->head] = t;
+        Seq_addhi(st->traces, t);
+}
+
+static inline void trace_abort(trace_state *st, int reason)
+{
+        trace_T t = st->recording;
+        st->recording = NULL;
+        st->aborts[reason]++;
+
+        /* the head may try again later, unless it keeps failing */
+        if (++st->tries[t->head] >= TRACE_MAX_TRIES) {
+                st->hot[t->head] = UINT32_MAX;
+        } else {
+                st->hot[t->head] = 0;
+        }
+
+        free(t->insts);
+        FREE(t);
+}
+
+static inline void trace_retire(trace_state *st, trace_T t)
+{
+        /* the head is never traced again while this program runs */
+        st->trace_at[t->head] = NULL;
+        st->hot[t->head] = UINT32_MAX;
+        t->live = false;
+        st->retired++;
+}
+
+static inline void trace_flush(trace_state *st)
+{
+        int num_traces = Seq_length(st->traces);
+        for (int i = 0; i < num_traces; i++) {
+                trace_T t = Seq_get(st->traces, i);
+                if (t->live && t->head < st->length) {
+                        st->trace_at[t->head] = NULL;
+                        st->hot[t->head] = 0;
+                }
+                t->live = false;
+        }
+        memset(st->covered, 0, st->length);
+        st->flushes++;
+}
+
+static inline void trace_reset(trace_state *st, uint32_t length)
+{
+        free(st->hot);
+        free(st->tries);
+        free(st->covered);
+        free(st->trace_at);
+
+        /* one extra entry keeps the tables allocated for an empty program */
+        st->length = length;
+        st->hot = calloc(length + 1, sizeof(uint32_t));
+        st->tries = calloc(length + 1, sizeof(uint8_t));
+        st->covered = calloc(length + 1, sizeof(uint8_t));
+        st->trace_at = calloc(length + 1, sizeof(trace_T));
+        assert(st->hot != NULL && st->tries != NULL);
+        assert(st->covered != NULL && st->trace_at != NULL);
+}
+
+static inline void trace_profile(trace_state *st, bool traced)
+{
+        static const char *names[14] = {
+                "cmov", "sload", "sstore", "add", "mul", "div", "nand",
+                "halt", "map", "unmap", "out", "in", "loadp", "lv"
+        };
+
+        uint64_t total = 0;
+        for (int op = 0; op < 14; op++) {
+                total += st->counts[op];
+        }
+
+        uint64_t in_traces = 0;
+        int num_traces = Seq_length(st->traces);
+        for (int i = 0; i < num_traces; i++) {
+                trace_T t = Seq_get(st->traces, i);
+                in_traces += t->executed;
+        }
+
+        fprintf(stderr, "um profile: %" PRIu64 " instructions\n", total);
+        for (int op = 0; op < 14; op++) {
+                fprintf(stderr, "  %-6s %14" PRIu64 "  %5.1f%%\n", names[op],
+                        st->counts[op],
+                        total ? 100.0 * st->counts[op] / total : 0.0);
+        }
+        if (!traced) {
+                return;
+        }
+
+        fprintf(stderr, "traces: %d recorded, %" PRIu64 " retired, "
+                "%" PRIu64 " flushes, %" PRIu64 " instructions in traces "
+                "(%.1f%%)\n", num_traces, st->retired, st->flushes, in_traces,
+                total ? 100.0 * in_traces / total : 0.0);
+        fprintf(stderr, "aborted: %" PRIu64 " too long, %" PRIu64 " halt, "
+                "%" PRIu64 " program load, %" PRIu64 " code write\n",
+                st->aborts[ABORT_TOO_LONG], st->aborts[ABORT_HALT],
+                st->aborts[ABORT_PROGRAM_LOAD], st->aborts[ABORT_CODE_WRITE]);
+        fprintf(stderr, "%8s %6s %10s %12s %14s %10s %10s %10s\n",
+                "head", "length", "entries", "loops", "instructions",
+                "cmov exit", "jump exit", "code write");
+        for (int i = 0; i < num_traces; i++) {
+                trace_T t = Seq_get(st->traces, i);
+                fprintf(stderr, "%8" PRIu32 " %6d %10" PRIu64 " %12" PRIu64
+                        " %14" PRIu64 " %10" PRIu64 " %10" PRIu64
+                        " %10" PRIu64 "\n",
+                        t->head, t->length, t->entries, t->loops, t->executed,
+                        t->exits[EXIT_CMOV_GUARD], t->exits[EXIT_JUMP_GUARD],
+                        t->exits[EXIT_CODE_WRITE]);
+        }
+}
+
+static inline void trace_free(trace_state *st)
+{
+        if (st->recording != NULL) {
+                free(st->recording->insts);
+                FREE(st->recording);
+        }
+
+        while (Seq_length(st->traces) > 0) {
+                trace_T t = Seq_remlo(st->traces);
+                free(t->insts);
+                FREE(t);
+        }
+        Seq_free(&st->traces);
+
+        free(st->hot);
+        free(st->tries);
+        free(st->covered);
+        free(st->trace_at);
+}
+
+static int symbol_by_offset(const void *x, const void *y)
+{
+        const symbol_T a = *(const symbol_T *)x, b = *(const symbol_T *)y;
+        return (a->offset > b->offset) - (a->offset < b->offset);
+}
+
+static int symbol_by_self(const void *x, const void *y)
+{
+        const symbol_T a = *(const symbol_T *)x, b = *(const symbol_T *)y;
+        if (a->self != b->self) {
+                return (a->self < b->self) - (a->self > b->self);
+        }
+        return (a->offset > b->offset) - (a->offset < b->offset);
+}
+
+static inline symbol_profile *symbol_load(const char *path, uint32_t length)
+{
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL) {
+                RAISE(Bad_Symbols);
+        }
+
+        symbol_profile *sp;
+        NEW(sp);
+        assert(sp != NULL);
+        memset(sp, 0, sizeof(*sp));
+
+        /* one "offset label" line per label, as mksymbols writes them */
+        int capacity = 64;
+        sp->symbols = malloc(capacity * sizeof(symbol_T));
+        assert(sp->symbols != NULL);
+
+        char name[256];
+        uint32_t offset;
+        int got;
+        while ((got = fscanf(fp, "%" SCNu32 " %255s", &offset, name)) == 2) {
+                if (sp->num_symbols == capacity) {
+                        capacity *= 2;
+                        sp->symbols = realloc(sp->symbols,
+                                              capacity * sizeof(symbol_T));
+                        assert(sp->symbols != NULL);
+                }
+
+                symbol_T sym;
+                NEW(sym);
+                assert(sym != NULL);
+                memset(sym, 0, sizeof(*sym));
+                sym->name = malloc(strlen(name) + 1);
+                assert(sym->name != NULL);
+                strcpy(sym->name, name);
+                sym->offset = offset;
+                sp->symbols[sp->num_symbols++] = sym;
+        }
+        fclose(fp);
+        if (got != EOF) {
+                RAISE(Bad_Symbols);
+        }
+
+        qsort(sp->symbols, sp->num_symbols, sizeof(symbol_T),
+              symbol_by_offset);
+
+        /* each word belongs to the last label at or before it */
+        sp->length = length;
+        sp->symbol_at = malloc((length + 1) * sizeof(uint32_t));
+        assert(sp->symbol_at != NULL);
+        uint32_t current = NO_SYMBOL;
+        int next = 0;
+        for (uint32_t pc = 0; pc < length; pc++) {
+                while (next < sp->num_symbols &&
+                       sp->symbols[next]->offset <= pc) {
+                        current = next++;
+                }
+                sp->symbol_at[pc] = current;
+        }
+
+        sp->capacity = 64;
+        sp->stack = malloc(sp->capacity * sizeof(call_frame));
+        assert(sp->stack != NULL);
+
+        return sp;
+}
+
+static inline void symbol_count(symbol_profile *sp, uint32_t pc)
+{
+        sp->executed++;
+        if (sp->replaced || sp->symbol_at[pc] == NO_SYMBOL) {
+                sp->unattributed++;
+                return;
+        }
+        sp->symbols[sp->symbol_at[pc]]->self++;
+}
+
+static inline void symbol_jump(symbol_profile *sp, uint32_t pc,
+                               uint32_t target, uint32_t r1)
+{
+        if (sp->replaced) {
+                return;
+        }
+
+        /* a jump to the return address of a pending call returns from it
+         * and from any call made after it
+         */
+        for (int i = sp->depth - 1; i >= 0; i--) {
+                if (sp->stack[i].ret == target) {
+                        while (sp->depth > i) {
+                                symbol_return(sp);
+                        }
+                        return;
+                }
+        }
+
+        /* "goto label linking r1" leaves the word after the jump in r1 */
+        if (r1 != pc + 1 || target >= sp->length) {
+                return;
+        }
+
+        if (sp->depth == sp->capacity) {
+                sp->capacity *= 2;
+                sp->stack = realloc(sp->stack,
+                                    sp->capacity * sizeof(call_frame));
+                assert(sp->stack != NULL);
+        }
+        uint32_t index = sp->symbol_at[target];
+        sp->stack[sp->depth].symbol = index;
+        sp->stack[sp->depth].ret = r1;
+        sp->depth++;
+
+        if (index == NO_SYMBOL) {
+                return;
+        }
+
+        /* recursive calls count toward the outermost one only */
+        symbol_T sym = sp->symbols[index];
+        sym->calls++;
+        if (sym->depth++ == 0) {
+                sym->entered = sp->executed;
+        }
+}
+
+static inline void symbol_return(symbol_profile *sp)
+{
+        uint32_t index = sp->stack[--sp->depth].symbol;
+        if (index == NO_SYMBOL) {
+                return;
+        }
+
+        symbol_T sym = sp->symbols[index];
+        if (--sym->depth == 0) {
+                sym->inclusive += sp->executed - sym->entered;
+        }
+}
+
+static inline void symbol_report(symbol_profile *sp)
+{
+        /* calls still pending at halt end there */
+        while (sp->depth > 0) {
+                symbol_return(sp);
+        }
+
+        symbol_T *order = malloc((sp->num_symbols + 1) * sizeof(symbol_T));
+        assert(order != NULL);
+        memcpy(order, sp->symbols, sp->num_symbols * sizeof(symbol_T));
+        qsort(order, sp->num_symbols, sizeof(symbol_T), symbol_by_self);
+
+        fprintf(stderr, "%-24s %8s %14s %6s %10s %14s\n", "label", "offset",
+                "instructions", "%", "calls", "inclusive");
+        for (int i = 0; i < sp->num_symbols; i++) {
+                symbol_T sym = order[i];
+                if (sym->self == 0 && sym->calls == 0) {
+                        continue;
+                }
+                fprintf(stderr, "%-24s %8" PRIu32 " %14" PRIu64 " %5.1f%%"
+                        " %10" PRIu64 " %14" PRIu64 "\n", sym->name,
+                        sym->offset, sym->self,
+                        sp->executed ? 100.0 * sym->self / sp->executed : 0.0,
+                        sym->calls, sym->inclusive);
+        }
+        if (sp->unattributed > 0) {
+                fprintf(stderr, "%-24s %8s %14" PRIu64 " %5.1f%%\n",
+                        "(no label)", "", sp->unattributed,
+                        100.0 * sp->unattributed / sp->executed);
+        }
+
+        free(order);
+}
+
+static inline void symbol_free(symbol_profile *sp)
+{
+        for (int i = 0; i < sp->num_symbols; i++) {
+                free(sp->symbols[i]->name);
+                FREE(sp->symbols[i]);
+        }
+        free(sp->symbols);
+        free(sp->symbol_at);
+        free(sp->stack);
+        FREE(sp);
+}
+
+static inline void conditional_move(int reg_a, int reg_b, int reg_c, uint32_t *reg)
 {
-        assert(mem != NULL);
         assert(reg != NULL);
 
         if (reg_c >=  8 || reg_c < 0 || reg_b >=  8 || reg_b < 0 || reg_a >=  8 || reg_a < 0) {
                 RAISE(Word_Bounds);
         }
-        
-        /* Retrieve the segment and word indices */
-        uint32_t segment_ind = reg[reg_a];
-        int word_ind = reg[reg_b];
 
-        /* check for requirements */
-        if (segment_ind >= (uint32_t)Seq_length(mem)) {
-                RAISE(Word_Bounds);
+        if (reg[reg_c] != 0) {
+                reg[reg_a] = reg[reg_b];
         }
+}
 
-        segment_T seg_T = Seq_get(mem, segment_ind);
-        uint32_t *seg = seg_T->seg_arr;
+static inline void segmented_load(int reg_a, int reg_b, int reg_c, Seq_T mem, uint32_t *reg)
+{
+        assert(mem != NULL);
+        assert(reg != NULL);
 
-        /* check for requirements */
-        if (seg == NULL) {
-                RAISE(Segment_Unmapped);
+        if (reg_c >=  8 || reg_c < 0 || reg_b >=  8 || reg_b < 0 || reg_a >=  8 || reg_a < 0) {
+                RAISE(Word_Bounds);
         }
 
-        if (word_ind >= seg_T->length) {
+        reg[reg_a] = load_word(mem, reg[reg_b], reg[reg_c]);
+}
+
+static inline void segmented_store(int reg_a, int reg_b, int reg_c, Seq_T mem, uint32_t *reg)
+{
+        assert(mem != NULL);
+        assert(reg != NULL);
+
+        if (reg_c >=  8 || reg_c < 0 || reg_b >=  8 || reg_b < 0 || reg_a >=  8 || reg_a < 0) {
                 RAISE(Word_Bounds);
         }
 
         /* Update value in memory to be equal to the word at reg index reg_c */
-        seg[word_ind] =  reg[reg_c];
+        store_word(mem, reg[reg_a], reg[reg_b], reg[reg_c]);
 }
 
 static inline void addition(int reg_a, int reg_b, int reg_c, uint32_t *reg)
@@ -454,17 +1455,127 @@ static inline void map_segment(int reg_b, int reg_c, Seq_T mem, uint32_t *reg, S
                 RAISE(Word_Bounds);
         }
 
-        /* initialize the new segment with 0's as words */
-        int num_words = reg[reg_c];
-        uint32_t *new_seg = malloc(num_words * sizeof(uint32_t));
-        assert(new_seg != NULL);
+        /* store new segment id in register with index reg_b */
+        reg[reg_b] = map_words(mem, id_m, reg[reg_c]);
+}
 
-        for (int i = 0; i < num_words; i++) {
-                new_seg[i] = (uint32_t)0;
+static inline void unmap_segment(int reg_c, Seq_T mem, uint32_t *reg, Seq_T id_m)
+{
+        assert(mem != NULL);
+        assert(reg != NULL);
+        assert(id_m != NULL);
+
+        if (reg_c >=  8 || reg_c < 0) {
+                RAISE(Word_Bounds);
+        }
+
+        unmap_id(mem, id_m, reg[reg_c]);
+}
+
+static inline void output(int reg_c, uint32_t *reg)
+{
+        assert(reg != NULL);
+
+        if (reg_c >=  8 || reg_c < 0) {
+                RAISE(Word_Bounds);
+        }
+
+        output_value(reg[reg_c]);
+}
+
+static inline void input(int reg_c, uint32_t *reg)
+{
+        assert(reg != NULL);
+
+        if (reg_c >=  8 || reg_c < 0) {
+                RAISE(Word_Bounds);
+        }
+
+        reg[reg_c] = input_value();
+}
+
+static inline int load_program(int reg_b, int reg_c, Seq_T mem, uint32_t *reg)
+{
+        /* checks for requirements */
+        assert(mem != NULL);
+        assert(reg != NULL);
+
+        if (reg_c >=  8 || reg_c < 0 || reg_b >=  8 || reg_b < 0) {
+                RAISE(Word_Bounds);
         }
         
-        uint32_t segment_id = 0;
+        /* if segment to replace segment 0 is not segment 0 itself: */
+        if (reg[reg_b] != 0) {
+                duplicate_program(mem, reg[reg_b]);
+        }
+
+        /* new program counter is returned */
+        return reg[reg_c];
+}
+
+static inline void load_value(int reg_a, int val, uint32_t *reg)
+{
+        assert(reg != NULL);
+
+        if (reg_a >=  8 || reg_a < 0) {
+                RAISE(Word_Bounds);
+        }
         
+        reg[reg_a] = (uint32_t)val;
+}
+static inline uint32_t load_word(Seq_T mem, uint32_t seg_id, uint32_t offset)
+{
+        /* check for requirements */
+        if (seg_id >= (uint32_t)Seq_length(mem)) {
+                RAISE(Word_Bounds);
+        }
+
+        segment_T seg_T = Seq_get(mem, seg_id);
+        uint32_t *seg = seg_T->seg_arr;
+
+        /* check for requirements */
+        if (seg == NULL) {
+                RAISE(Segment_Unmapped);
+        }
+        if (offset >= (uint32_t)seg_T->length) {
+                RAISE(Word_Bounds);
+        }
+
+        return seg[offset];
+}
+
+static inline void store_word(Seq_T mem, uint32_t seg_id, uint32_t offset, uint32_t value)
+{
+        /* check for requirements */
+        if (seg_id >= (uint32_t)Seq_length(mem)) {
+                RAISE(Word_Bounds);
+        }
+
+        segment_T seg_T = Seq_get(mem, seg_id);
+        uint32_t *seg = seg_T->seg_arr;
+
+        /* check for requirements */
+        if (seg == NULL) {
+                RAISE(Segment_Unmapped);
+        }
+        if (offset >= (uint32_t)seg_T->length) {
+                RAISE(Word_Bounds);
+        }
+
+        seg[offset] = value;
+}
+
+static inline uint32_t map_words(Seq_T mem, Seq_T id_m, uint32_t num_words)
+{
+        /* initialize the new segment with 0's as words. at least one word
+         * is allocated so a mapped segment is never NULL
+         */
+        uint32_t *new_seg = calloc(num_words == 0 ? 1 : num_words,
+                                   sizeof(uint32_t));
+        assert(new_seg != NULL);
+
+        uint32_t segment_id = 0;
+
         /* if there is no space available in the current memory, add segment to
          * the end. if there is, place the segment to an unmapped location 
          * retrieved from id_m. update new segment_id
@@ -485,151 +1596,85 @@ static inline void map_segment(int reg_b, int reg_c, Seq_T mem, uint32_t *reg, S
                 seg_exist->length = num_words;
         }
 
-        /* store new segment id in register with index reg_b */
-        reg[reg_b] = (uint32_t)segment_id;
+        return segment_id;
 }
 
-static inline void unmap_segment(int reg_c, Seq_T mem, uint32_t *reg, Seq_T id_m)
+static inline void unmap_id(Seq_T mem, Seq_T id_m, uint32_t seg_id)
 {
-        assert(mem != NULL);
-        assert(reg != NULL);
-        assert(id_m != NULL);
-
-        if (reg_c >=  8 || reg_c < 0) {
-                RAISE(Word_Bounds);
-        }
-        
-        /* retrieve the segment id to be unmapped and add it to free ids seq */
-        uint32_t segment_ind = reg[reg_c];
-        Seq_addlo(id_m, (void *)(uintptr_t)segment_ind);
+        /* add the segment id to be unmapped to free ids seq */
+        Seq_addlo(id_m, (void *)(uintptr_t)seg_id);
 
         /* raise an error if the user tries to unmap segment 0 */
-        if (segment_ind == 0) {
+        if (seg_id == 0) {
                 RAISE(Faulty_Unmap);
         }
-        
+
         /* retrieve the segment to be unmapped */
-        if (segment_ind >= (uint32_t)Seq_length(mem)) {
+        if (seg_id >= (uint32_t)Seq_length(mem)) {
                 RAISE(Word_Bounds);
         }
-        
-        segment_T unmap_seg_T = Seq_get(mem, segment_ind);
-        uint32_t *unmap_seg = unmap_seg_T->seg_arr;
-        
+
+        segment_T unmap_seg_T = Seq_get(mem, seg_id);
+
         /* raise an error if the user tries to unmap a not mapped segment */
-        if (unmap_seg == NULL) {
+        if (unmap_seg_T->seg_arr == NULL) {
                 RAISE(Faulty_Unmap);
         }
-        
+
         /* frees segment to be unmapped and places NULL in its place */
-        free(unmap_seg);
-        unmap_seg = NULL;
+        free(unmap_seg_T->seg_arr);
+        unmap_seg_T->seg_arr = NULL;
         unmap_seg_T->length = 0;
 }
 
-static inline void output(int reg_c, uint32_t *reg)
+static inline void output_value(uint32_t val)
 {
-        assert(reg != NULL);
-
-        if (reg_c >=  8 || reg_c < 0) {
-                RAISE(Word_Bounds);
-        }
-        
-        /* Retrieve value from register */
-        uint32_t val = reg[reg_c];
-        
         /* Check for value range and print if there is no problem */
         if (val > 255) {
                 RAISE(IO_Bounds);
         }
-        
-        printf("%c", val);
+
+        putchar(val);
 }
 
-static inline void input(int reg_c, uint32_t *reg)
+static inline uint32_t input_value(void)
 {
-        assert(reg != NULL);
-
         /* Get input */
-        int c;
-        c = getc(stdin);
+        int c = getc(stdin);
 
-        if (reg_c >=  8 || reg_c < 0) {
-                RAISE(Word_Bounds);
-        }
-
-        /* Check if EOF is signaled or if input is in bounds or place the value
-        in the register */
+        /* EOF is signaled with a word in which every bit is 1 */
         if (c == EOF) {
-                uint32_t zero = (uint32_t)0;
-                uint32_t max_val = ~zero;
-                reg[reg_c] = max_val;
+                return ~((uint32_t)0);
         } else if (c > 255 || c < 0) {
                 RAISE(IO_Bounds);
-        } else {
-                reg[reg_c] = c;
         }
+
+        return c;
 }
 
-static inline int load_program(int reg_b, int reg_c, Seq_T mem, uint32_t *reg)
+static inline void duplicate_program(Seq_T mem, uint32_t seg_id)
 {
-        /* checks for requirements */
-        assert(mem != NULL);
-        assert(reg != NULL);
-
-        if (reg_c >=  8 || reg_c < 0 || reg_b >=  8 || reg_b < 0) {
+        /* duplicates the segment to be put at segment 0 */
+        if (seg_id >= (uint32_t)Seq_length(mem)) {
                 RAISE(Word_Bounds);
         }
-        
-        /* gets index of segment to replace segment 0 */
-        uint32_t value_b = reg[reg_b];
-        
-        /* if segment to replace segment 0 is not segment 0 itself: */
-        if (value_b != 0) {
-                /* segment at 0 is unmapped and freed */
-                segment_T unmap_seg_T = Seq_get(mem, 0);     
-                uint32_t *unmap_seg = unmap_seg_T->seg_arr;
 
-                free(unmap_seg);
-                unmap_seg_T->length = 0;
-
-                /* duplicates the segmnt to be put at segment 0 */
-                if (value_b >= (uint32_t)Seq_length(mem)) {
-                        RAISE(Word_Bounds);
-                }
-                
-                segment_T dup_T = Seq_get(mem, value_b);     
-                uint32_t *dup = dup_T->seg_arr;
-                if (dup == NULL) {
-                        RAISE(Segment_Unmapped);
-                }
-                
-                int num_words = dup_T->length;
-
-                /* initiates a new segment with number of words defined */
-                uint32_t *new_seg = malloc(num_words * sizeof(uint32_t));
-
-                /* adds words from the original segment to the duplicate */
-                for (int i = 0; i < num_words; i++) {
-                        new_seg[i] = dup[i];
-                }
-                
-                /* segment is duplicated and put into segment 0 */
-                unmap_seg_T->seg_arr = new_seg;
-                unmap_seg_T->length = num_words;
+        segment_T dup_T = Seq_get(mem, seg_id);
+        uint32_t *dup = dup_T->seg_arr;
+        if (dup == NULL) {
+                RAISE(Segment_Unmapped);
         }
 
-        /* new program counter is returned */
-        return reg[reg_c];
-}
-
-static inline void load_value(int reg_a, int val, uint32_t *reg)
-{
-        assert(reg != NULL);
+        int num_words = dup_T->length;
 
-        if (reg_a >=  8 || reg_a < 0) {
-                RAISE(Word_Bounds);
-        }
-        
-        reg[reg_a] = (uint32_t)val;
-}
\ No newline at end of file
+        /* initiates a new segment with number of words defined */
+        uint32_t *new_seg = malloc(num_words * sizeof(uint32_t));
+        assert(new_seg != NULL || num_words == 0);
+        memcpy(new_seg, dup, num_words * sizeof(uint32_t));
+
+        /* segment at 0 is freed and replaced with the duplicate */
+        segment_T prog_T = Seq_get(mem, 0);
+        free(prog_T->seg_arr);
+        prog_T->seg_arr = new_seg;
+        prog_T->length = num_words;
+}
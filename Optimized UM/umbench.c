@@ -0,0 +1,578 @@
+/*
+ *      umbench.c
+ *      by Cansu Birsen (cbirse01), Ayse Idil Kolabas (akolab01)
+ *      December 3, 2023
+ *      Optimized UM
+ *
+ *      Opcode microbenchmarks for UM interpreters. Writes one synthetic .um
+ *      program per stressed operation into a directory and, when given one
+ *      or more um executables, runs every program on every executable and
+ *      prints the CPU time and cycles per executed instruction of each run.
+ *
+ *      Every program is a straight line setup followed by one loop. The
+ *      loop body is the stressed operation unrolled UNROLL times and five
+ *      instructions of loop control, so the stressed operation makes up
+ *      almost all of the instructions run and the instruction count is
+ *      known exactly without instrumenting the interpreters.
+ *
+ *      Usage: umbench [-o dir] [-s scale] [-g ghz] [um ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+#include <stdbool.h>
+
+/* copies of the stressed operation in one loop body */
+#define UNROLL 64
+
+/* instructions of loop control at the end of every loop body */
+#define LOOP_CONTROL 5
+
+/* segments linked into a ring by the load/store benchmark */
+#define RING_SEGMENTS 4096
+
+/* registers, r0 is never written so it always holds 0 */
+enum { R0, R1, R2, R3, R4, R5, R6, R7 };
+
+/* opcodes of the UM */
+enum um_opcode {
+        CMOV = 0, SLOAD, SSTORE, ADD, MUL, DIV, NAND,
+        HALT, MAP, UNMAP, OUT, IN, LOADP, LV
+};
+
+/* a program being assembled */
+typedef struct program {
+        uint32_t *words;
+        uint32_t length;
+        uint32_t capacity;
+} program;
+
+/* one microbenchmark */
+typedef struct bench {
+        const char *name;
+        const char *class;
+        uint32_t iterations;    /* loop iterations at scale 1 */
+        void (*setup)(program *p, const struct bench *b);
+        void (*payload)(program *p, const struct bench *b);
+        uint32_t arg;           /* operand of the payload, or 0 */
+        bool from_segment;      /* loop runs from a copy of segment r5 */
+} bench;
+
+/******************************** emit *********************************
+ *
+ * Appends a word to the program, growing it when it is full
+ *
+ * Inputs:
+ *              program *p: program being assembled
+ *              uint32_t word: instruction to append
+ * Return:
+ *              none
+ * Expects:
+ *              p to not be null and allocation to succeed
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static void emit(program *p, uint32_t word)
+{
+        assert(p != NULL);
+
+        if (p->length == p->capacity) {
+                p->capacity = p->capacity == 0 ? 256 : 2 * p->capacity;
+                p->words = realloc(p->words, p->capacity * sizeof(uint32_t));
+                assert(p->words != NULL);
+        }
+        p->words[p->length++] = word;
+}
+
+/******************************** three *********************************
+ *
+ * Returns a three register instruction
+ *
+ * Inputs:
+ *              enum um_opcode op: any opcode but LV
+ *              unsigned a, b, c: registers A, B and C
+ * Return:
+ *              the encoded instruction
+ * Expects:
+ *              registers to be between 0 and 7
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static uint32_t three(enum um_opcode op, unsigned a, unsigned b, unsigned c)
+{
+        assert(a < 8 && b < 8 && c < 8);
+        return (uint32_t)op << 28 | a << 6 | b << 3 | c;
+}
+
+/******************************** load_value *********************************
+ *
+ * Returns a load value instruction
+ *
+ * Inputs:
+ *              unsigned a: register to load into
+ *              uint32_t value: value to load
+ * Return:
+ *              the encoded instruction
+ * Expects:
+ *              a to be between 0 and 7 and value to fit in 25 bits
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static uint32_t load_value(unsigned a, uint32_t value)
+{
+        assert(a < 8 && value < (1u << 25));
+        return (uint32_t)LV << 28 | a << 25 | value;
+}
+
+/*************************** loop payload emitters ***************************
+ *
+ * Each emits one copy of the stressed operation of a benchmark
+ *
+ * Inputs:
+ *              program *p: program being assembled
+ *              const bench *b: the benchmark
+ * Return:
+ *              none
+ * Expects:
+ *              the setup of the benchmark to have run
+ * Notes:
+ *              r1 and r4 are free for the payload, r2, r3, r6 and r7 belong
+ *              to the loop control and r5 to the setup
+ *
+ *****************************************************************************/
+static void add_chain(program *p, const bench *b)
+{
+        (void)b;
+        emit(p, three(ADD, R1, R1, R4));
+}
+
+static void nand_chain(program *p, const bench *b)
+{
+        (void)b;
+        emit(p, three(NAND, R1, R1, R4));
+}
+
+static void map_unmap(program *p, const bench *b)
+{
+        (void)b;
+        emit(p, three(MAP, R0, R1, R4));
+        emit(p, three(UNMAP, R0, R0, R1));
+}
+
+/* walks the ring one segment per load, storing into each segment passed */
+static void ring_load_store(program *p, const bench *b)
+{
+        (void)b;
+        emit(p, three(SLOAD, R5, R5, R0));
+        emit(p, three(SSTORE, R5, R4, R1));
+}
+
+/* jumps to the next instruction of segment 0, or of a copy of segment r5 */
+static void jump_next(program *p, const bench *b)
+{
+        unsigned segment = b->from_segment ? R5 : R0;
+        emit(p, load_value(R4, p->length + 2));
+        emit(p, three(LOADP, R0, segment, R4));
+}
+
+static void output(program *p, const bench *b)
+{
+        (void)b;
+        emit(p, three(OUT, R0, R0, R4));
+}
+
+/***************************** setup emitters ******************************
+ *
+ * Each emits the straight line setup of a benchmark
+ *
+ * Inputs:
+ *              program *p: program being assembled
+ *              const bench *b: the benchmark
+ * Return:
+ *              none
+ * Expects:
+ *              p to hold no loop yet
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static void no_setup(program *p, const bench *b)
+{
+        (void)p;
+        (void)b;
+}
+
+static void set_operand(program *p, const bench *b)
+{
+        emit(p, load_value(R4, b->arg == 0 ? 12345 : b->arg));
+}
+
+static void set_character(program *p, const bench *b)
+{
+        (void)b;
+        emit(p, load_value(R4, '.'));
+}
+
+/* maps RING_SEGMENTS two word segments, word 0 of each holding the id of
+ * the next, and leaves the first id in r5 and 1 in r4
+ */
+static void build_ring(program *p, const bench *b)
+{
+        (void)b;
+        emit(p, load_value(R4, 2));
+        emit(p, three(MAP, R0, R5, R4));
+        emit(p, three(ADD, R1, R5, R0));
+        for (int i = 1; i < RING_SEGMENTS; i++) {
+                emit(p, three(MAP, R0, R3, R4));
+                emit(p, three(SSTORE, R1, R0, R3));
+                emit(p, three(ADD, R1, R3, R0));
+        }
+        emit(p, three(SSTORE, R1, R0, R5));
+        emit(p, load_value(R4, 1));
+}
+
+static const bench benches[] = {
+        { "loop",          "control", 20000000, no_setup,
+          NULL, 0, false },
+        { "add",           "alu",     2500000, set_operand,
+          add_chain, 0, false },
+        { "nand",          "alu",     2500000, set_operand,
+          nand_chain, 0, false },
+        { "map_1",         "map",      200000, set_operand,
+          map_unmap, 1, false },
+        { "map_64",        "map",      100000, set_operand,
+          map_unmap, 64, false },
+        { "map_4096",      "map",       50000, set_operand,
+          map_unmap, 4096, false },
+        { "load_store",    "memory",  1500000, build_ring,
+          ring_load_store, 0, false },
+        { "loadp_0",       "loadp",   1500000, no_setup,
+          jump_next, 0, false },
+        { "loadp_nonzero", "loadp",    100000, no_setup,
+          jump_next, 0, true },
+        { "output",        "io",      1000000, set_character,
+          output, 0, false },
+};
+
+#define NUM_BENCHES (sizeof(benches) / sizeof(benches[0]))
+
+/******************************** emit_loop *********************************
+ *
+ * Emits the loop of a benchmark, which counts r7 down to 0, and the halt
+ * after it
+ *
+ * Inputs:
+ *              program *p: program being assembled, whose word i runs as
+ *                          word i of segment 0
+ *              const bench *b: the benchmark
+ * Return:
+ *              number of instructions in the loop body
+ * Expects:
+ *              r0 to hold 0, r6 0xffffffff and r7 the iteration count
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static uint32_t emit_loop(program *p, const bench *b)
+{
+        uint32_t start = p->length;
+
+        for (int i = 0; b->payload != NULL && i < UNROLL; i++) {
+                b->payload(p, b);
+        }
+
+        /* r7 -= 1, then jump to start if r7 != 0, to the halt otherwise */
+        uint32_t halt = p->length + LOOP_CONTROL;
+        emit(p, three(ADD, R7, R7, R6));
+        emit(p, load_value(R3, halt));
+        emit(p, load_value(R2, start));
+        emit(p, three(CMOV, R3, R2, R7));
+        emit(p, three(LOADP, R0, R0, R3));
+        emit(p, three(HALT, R0, R0, R0));
+
+        return halt - start;
+}
+
+/****************************** emit_segment ******************************
+ *
+ * Emits code that maps a segment holding the given words and leaves its id
+ * in r5
+ *
+ * Inputs:
+ *              program *p: program being assembled
+ *              const program *words: the words to put in the segment
+ * Return:
+ *              none
+ * Expects:
+ *              p and words to not be null
+ * Notes:
+ *              uses r1 and r4. a word does not fit in a load value, so
+ *              each is built from its two 16-bit halves
+ *
+ *****************************************************************************/
+static void emit_segment(program *p, const program *words)
+{
+        emit(p, load_value(R4, words->length));
+        emit(p, three(MAP, R0, R5, R4));
+
+        for (uint32_t i = 0; i < words->length; i++) {
+                uint32_t word = words->words[i];
+                emit(p, load_value(R1, word >> 16));
+                emit(p, load_value(R4, 1u << 16));
+                emit(p, three(MUL, R1, R1, R4));
+                emit(p, load_value(R4, word & 0xffff));
+                emit(p, three(ADD, R1, R1, R4));
+                emit(p, load_value(R4, i));
+                emit(p, three(SSTORE, R5, R4, R1));
+        }
+}
+
+/****************************** write_bench *******************************
+ *
+ * Assembles a benchmark and writes it to dir/name.um
+ *
+ * Inputs:
+ *              const bench *b: the benchmark
+ *              const char *dir: directory to write into
+ *              uint32_t iterations: times the loop runs
+ * Return:
+ *              number of instructions the program executes
+ * Expects:
+ *              iterations to be between 1 and 2^25 - 1 and the file to be
+ *              writable
+ * Notes:
+ *              exits with EXIT_FAILURE if the file cannot be written
+ *
+ *****************************************************************************/
+static uint64_t write_bench(const bench *b, const char *dir,
+                            uint32_t iterations)
+{
+        program p = { NULL, 0, 0 };
+        uint32_t body;
+
+        b->setup(&p, b);
+        emit(&p, load_value(R7, iterations));
+        emit(&p, three(NAND, R6, R0, R0));
+
+        if (b->from_segment) {
+                program loop = { NULL, 0, 0 };
+                body = emit_loop(&loop, b);
+                emit_segment(&p, &loop);
+                emit(&p, three(LOADP, R0, R5, R0));
+                free(loop.words);
+        } else {
+                body = emit_loop(&p, b);
+        }
+
+        /* everything but the loop and halt runs once */
+        uint64_t once = p.length - (b->from_segment ? 0 : body + 1);
+        uint64_t executed = once + (uint64_t)iterations * body + 1;
+
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s.um", dir, b->name);
+        FILE *fp = fopen(path, "wb");
+        if (fp == NULL) {
+                fprintf(stderr, "Could not open %s for writing.\n", path);
+                exit(EXIT_FAILURE);
+        }
+
+        /* words are stored big-endian */
+        for (uint32_t i = 0; i < p.length; i++) {
+                uint32_t word = p.words[i];
+                putc(word >> 24, fp);
+                putc(word >> 16 & 0xff, fp);
+                putc(word >> 8 & 0xff, fp);
+                putc(word & 0xff, fp);
+        }
+        fclose(fp);
+        free(p.words);
+
+        return executed;
+}
+
+/******************************** run_um *********************************
+ *
+ * Runs a um on a program with input from /dev/null and output thrown away
+ *
+ * Inputs:
+ *              const char *um: path of the um executable
+ *              const char *path: path of the .um program
+ * Return:
+ *              user plus system CPU seconds of the run, or a negative number
+ *              if the um could not be run or did not exit with status 0
+ * Expects:
+ *              um and path to not be null
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static double run_um(const char *um, const char *path)
+{
+        pid_t pid = fork();
+        if (pid < 0) {
+                return -1;
+        }
+
+        if (pid == 0) {
+                int null_in = open("/dev/null", O_RDONLY);
+                int null_out = open("/dev/null", O_WRONLY);
+                if (null_in < 0 || null_out < 0) {
+                        _exit(127);
+                }
+                dup2(null_in, STDIN_FILENO);
+                dup2(null_out, STDOUT_FILENO);
+                execl(um, um, path, (char *)NULL);
+                _exit(127);
+        }
+
+        int status;
+        struct rusage usage;
+        if (wait4(pid, &status, 0, &usage) < 0 ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                return -1;
+        }
+
+        return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+               usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+/******************************** cpu_ghz *********************************
+ *
+ * Returns the clock rate of the first CPU in /proc/cpuinfo
+ *
+ * Inputs:
+ *              none
+ * Return:
+ *              clock rate in GHz, or 0 if it is not known
+ * Expects:
+ *              none
+ * Notes:
+ *              the rate can change while a benchmark runs, pass -g to fix it
+ *
+ *****************************************************************************/
+static double cpu_ghz(void)
+{
+        FILE *fp = fopen("/proc/cpuinfo", "r");
+        if (fp == NULL) {
+                return 0;
+        }
+
+        char line[256];
+        double mhz = 0;
+        while (fgets(line, sizeof(line), fp) != NULL) {
+                if (sscanf(line, "cpu MHz : %lf", &mhz) == 1) {
+                        break;
+                }
+        }
+        fclose(fp);
+
+        return mhz / 1000;
+}
+
+static void usage(const char *prog)
+{
+        fprintf(stderr, "Usage: %s [-o dir] [-s scale] [-g ghz] [um ...]\n",
+                prog);
+        exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+        const char *dir = "umbench.d";
+        double scale = 1;
+        double ghz = 0;
+
+        int i = 1;
+        for (; i < argc && argv[i][0] == '-'; i++) {
+                if (i + 1 == argc) {
+                        usage(argv[0]);
+                } else if (strcmp(argv[i], "-o") == 0) {
+                        dir = argv[++i];
+                } else if (strcmp(argv[i], "-s") == 0) {
+                        scale = atof(argv[++i]);
+                } else if (strcmp(argv[i], "-g") == 0) {
+                        ghz = atof(argv[++i]);
+                } else {
+                        usage(argv[0]);
+                }
+        }
+        if (scale <= 0 || ghz < 0) {
+                usage(argv[0]);
+        }
+        if (ghz == 0) {
+                ghz = cpu_ghz();
+        }
+
+        int num_ums = argc - i;
+        char **ums = argv + i;
+
+        if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+                fprintf(stderr, "Could not create %s.\n", dir);
+                return EXIT_FAILURE;
+        }
+
+        for (int u = 0; u < num_ums; u++) {
+                printf("um %d: %s\n", u + 1, ums[u]);
+        }
+        printf("%-14s %-8s %12s", "program", "class", "instructions");
+        for (int u = 0; u < num_ums; u++) {
+                printf("  %5s %d %8s", "sec", u + 1,
+                       ghz > 0 ? "cyc/inst" : "ns/inst");
+        }
+        printf("\n");
+
+        for (unsigned b = 0; b < NUM_BENCHES; b++) {
+                double iterations = benches[b].iterations * scale;
+                if (iterations < 1 || iterations >= (1u << 25)) {
+                        fprintf(stderr, "Scale %g is out of range.\n",
+                                scale);
+                        return EXIT_FAILURE;
+                }
+
+                uint64_t executed = write_bench(&benches[b], dir,
+                                                (uint32_t)iterations);
+                printf("%-14s %-8s %12" PRIu64, benches[b].name,
+                       benches[b].class, executed);
+                fflush(stdout);
+
+                char path[4096];
+                snprintf(path, sizeof(path), "%s/%s.um", dir,
+                         benches[b].name);
+                for (int u = 0; u < num_ums; u++) {
+                        double seconds = run_um(ums[u], path);
+                        if (seconds < 0) {
+                                printf("  %7s %8s", "failed", "-");
+                                continue;
+                        }
+
+                        double per_inst = seconds * 1e9 / executed;
+                        printf("  %7.2f %8.2f", seconds,
+                               ghz > 0 ? per_inst * ghz : per_inst);
+                        fflush(stdout);
+                }
+                printf("\n");
+        }
+
+        return EXIT_SUCCESS;
+}
+
+#undef NUM_BENCHES
+#undef UNROLL
+#undef LOOP_CONTROL
+#undef RING_SEGMENTS
@@ -1,27 +1,103 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
 #include "assert.h"
 #include "compress40.h"
+#include "stream40.h"
+#include "block_rows.h"
+#include "parallel40.h"
+#include "chroma.h"
+#include "fixed40.h"
+#include "tile40.h"
 
-static void (*compress_or_decompress)(FILE *input) = compress40;
+static void (*compress_or_decompress)(FILE *input) = stream_compress40;
+
+/* --staged runs through the full size arrays of compress40.c */
+static bool staged = false;
+
+/* --rescale rescales decompressed rgb values by their min and max */
+static bool rescale = false;
+
+/* --fixed uses the fixed point steps of fixed40.c */
+static bool fixed = false;
+
+/* -j runs on this many threads; 0 means one for each CPU */
+static unsigned threads = 1;
+
+/* --tiled compresses to COMP40 format 3 */
+static bool tiled = false;
+
+/* --region decompresses only a rectangle of the image */
+static bool region = false;
 
 int main(int argc, char *argv[])
 {
         int i;
 
+        build_chroma_tables();
         for (i = 1; i < argc; i++) {
                 if (strcmp(argv[i], "-c") == 0) {
-                        compress_or_decompress = compress40;
+                        compress_or_decompress = stream_compress40;
                 } else if (strcmp(argv[i], "-d") == 0) {
-                        compress_or_decompress = decompress40;
+                        compress_or_decompress = stream_decompress40;
+                } else if (strcmp(argv[i], "--staged") == 0) {
+                        staged = true;
+                } else if (strcmp(argv[i], "--rescale") == 0) {
+                        rescale = true;
+                } else if (strcmp(argv[i], "--fixed") == 0) {
+                        fixed = true;
+                } else if (strcmp(argv[i], "--tiled") == 0) {
+                        tiled = true;
+                } else if (strcmp(argv[i], "--region") == 0 && 
+                           i + 1 < argc) {
+                        i++;
+                        unsigned x, y, width, height;
+                        int end = 0;
+                        sscanf(argv[i], "%u,%u,%u,%u%n", &x, &y, &width,
+                               &height, &end);
+                        if (end == 0 || argv[i][end] != '\0' || 
+                            width == 0 || height == 0) {
+                                fprintf(stderr, "%s: bad region '%s', "
+                                        "expected x,y,width,height\n",
+                                        argv[0], argv[i]);
+                                exit(1);
+                        }
+                        use_region(x, y, width, height);
+                        region = true;
+                } else if (strcmp(argv[i], "--kernel") == 0 && 
+                           i + 1 < argc) {
+                        i++;
+                        if (!use_block_row_kernel(argv[i])) {
+                                fprintf(stderr, "%s: no kernel '%s' on "
+                                        "this machine\n", argv[0], argv[i]);
+                                exit(1);
+                        }
+                } else if (strcmp(argv[i], "--check-chroma") == 0) {
+                        unsigned long differences = check_chroma_tables();
+                        printf("%lu differences from Arith40\n", 
+                               differences);
+                        exit(differences == 0 ? EXIT_SUCCESS : 1);
+                } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                        i++;
+                        char *end;
+                        threads = strtoul(argv[i], &end, 10);
+                        if (*argv[i] == '\0' || *end != '\0') {
+                                fprintf(stderr, "%s: bad thread count "
+                                        "'%s'\n", argv[0], argv[i]);
+                                exit(1);
+                        }
                 } else if (*argv[i] == '-') {
                         fprintf(stderr, "%s: unknown option '%s'\n",
                                 argv[0], argv[i]);
                         exit(1);
                 } else if (argc - i > 2) {
-                        fprintf(stderr, "Usage: %s -d [filename]\n"
-                                "       %s -c [filename]\n",
+                        fprintf(stderr, "Usage: %s -d [--staged] "
+                                "[--rescale] [--fixed] [-j threads] "
+                                "[--region x,y,w,h] [filename]\n"
+                                "       %s -c [--staged] [--kernel name] "
+                                "[--fixed] [-j threads] [--tiled] "
+                                "[filename]\n",
                                 argv[0], argv[0]);
                         exit(1);
                 } else {
@@ -29,6 +105,54 @@ int main(int argc, char *argv[])
                 }
         }
         assert(argc - i <= 1);    /* at most one file on command line */
+        if ((tiled || region) && (staged || rescale || fixed || 
+                                  threads != 1)) {
+                fprintf(stderr, "%s: --tiled and --region do not go with "
+                        "--staged, --rescale, --fixed or -j\n", argv[0]);
+                exit(1);
+        }
+        if (fixed && (staged || rescale || threads != 1)) {
+                fprintf(stderr, "%s: --fixed does not go with --staged, "
+                        "--rescale or -j\n", argv[0]);
+                exit(1);
+        }
+        if ((tiled && compress_or_decompress != stream_compress40) ||
+            (region && compress_or_decompress != stream_decompress40)) {
+                fprintf(stderr, "%s: --tiled goes with -c and --region "
+                        "with -d\n", argv[0]);
+                exit(1);
+        }
+        if (tiled && compress_or_decompress == stream_compress40) {
+                compress_or_decompress = tiled_compress40;
+        }
+        if (region && compress_or_decompress == stream_decompress40) {
+                compress_or_decompress = tiled_decompress40;
+        }
+        if (fixed && compress_or_decompress == stream_compress40) {
+                compress_or_decompress = fixed_compress40;
+        }
+        if (fixed && compress_or_decompress == stream_decompress40) {
+                compress_or_decompress = fixed_decompress40;
+        }
+        if (staged && compress_or_decompress == stream_compress40) {
+                compress_or_decompress = compress40;
+        }
+        if ((staged || rescale) && 
+            compress_or_decompress == stream_decompress40) {
+                compress_or_decompress = decompress40;
+        }
+        if (threads != 1 && compress_or_decompress == stream_compress40) {
+                use_threads(threads);
+                compress_or_decompress = parallel_compress40;
+        }
+        if (threads != 1 && compress_or_decompress == stream_decompress40) {
+                use_threads(threads);
+                compress_or_decompress = parallel_decompress40;
+        }
+        if (compress_or_decompress == stream_decompress40) {
+                /* Reads format 3 as well, and format 2 as before */
+                compress_or_decompress = tiled_decompress40;
+        }
         if (i < argc) {
                 FILE *fp = fopen(argv[i], "r");
                 assert(fp != NULL);
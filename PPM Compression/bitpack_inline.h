@@ -0,0 +1,126 @@
+/*
+ *      bitpack_inline.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Inline versions of the Bitpack get and new functions for fields whose
+ *      width and lsb are known when the program is compiled. They do not
+ *      check the width, the lsb or whether a value fits, so with constant
+ *      arguments each call compiles down to a few shifts and masks. The
+ *      checked functions of bitpack.c are for every other case
+ */
+
+#ifndef BITPACK_INLINE_INCLUDED
+#define BITPACK_INLINE_INCLUDED
+
+/* Standard C Libraries */
+#include <stdint.h>
+
+/************************** Bitpack_inline_getu ******************************
+ *
+ * Gets the unsigned subword of width width at lowest significant bit lsb
+ *
+ * Inputs:
+ *              uint64_t word: the codeword where the subword is stored
+ *              unsigned width: the width of the subword
+ *              unsigned lsb: the lowest significant bit of the subword
+ * Return:
+ *              the subword, as Bitpack_getu gives it
+ * Expects:
+ *              0 < width < 64
+ *              width + lsb <= 64
+ * Notes:
+ *              expectations are not checked
+ *
+ *****************************************************************************/
+static inline uint64_t Bitpack_inline_getu(uint64_t word, unsigned width,
+                                           unsigned lsb)
+{
+        return (word >> lsb) & (((uint64_t)1 << width) - 1);
+}
+
+/************************** Bitpack_inline_gets ******************************
+ *
+ * Gets the signed subword of width width at lowest significant bit lsb
+ *
+ * Inputs:
+ *              uint64_t word: the codeword where the subword is stored
+ *              unsigned width: the width of the subword
+ *              unsigned lsb: the lowest significant bit of the subword
+ * Return:
+ *              the subword, as Bitpack_gets gives it
+ * Expects:
+ *              0 < width < 64
+ *              width + lsb <= 64
+ * Notes:
+ *              expectations are not checked
+ *              flipping the sign bit and subtracting it back sign extends
+ *                      the subword without any branch
+ *
+ *****************************************************************************/
+static inline int64_t Bitpack_inline_gets(uint64_t word, unsigned width,
+                                          unsigned lsb)
+{
+        uint64_t sign = (uint64_t)1 << (width - 1);
+
+        return (int64_t)((Bitpack_inline_getu(word, width, lsb) ^ sign) -
+                         sign);
+}
+
+/************************** Bitpack_inline_newu ******************************
+ *
+ * Replaces the field of width width at lowest significant bit lsb of word
+ * with an unsigned value
+ *
+ * Inputs:
+ *              uint64_t word: the word to update
+ *              unsigned width: the width of the field
+ *              unsigned lsb: the lowest significant bit of the field
+ *              uint64_t value: the value to put in the field
+ * Return:
+ *              the updated word, as Bitpack_newu gives it
+ * Expects:
+ *              0 < width < 64
+ *              width + lsb <= 64
+ *              value to fit in width bits
+ * Notes:
+ *              expectations are not checked; a value that does not fit
+ *                      keeps only its width least significant bits
+ *
+ *****************************************************************************/
+static inline uint64_t Bitpack_inline_newu(uint64_t word, unsigned width,
+                                           unsigned lsb, uint64_t value)
+{
+        uint64_t mask = ((uint64_t)1 << width) - 1;
+
+        return (word & ~(mask << lsb)) | ((value & mask) << lsb);
+}
+
+/************************** Bitpack_inline_news ******************************
+ *
+ * Replaces the field of width width at lowest significant bit lsb of word
+ * with a signed value
+ *
+ * Inputs:
+ *              uint64_t word: the word to update
+ *              unsigned width: the width of the field
+ *              unsigned lsb: the lowest significant bit of the field
+ *              int64_t value: the value to put in the field
+ * Return:
+ *              the updated word, as Bitpack_news gives it
+ * Expects:
+ *              0 < width < 64
+ *              width + lsb <= 64
+ *              value to fit in width bits as a signed value
+ * Notes:
+ *              expectations are not checked; a value that does not fit
+ *                      keeps only its width least significant bits
+ *
+ *****************************************************************************/
+static inline uint64_t Bitpack_inline_news(uint64_t word, unsigned width,
+                                           unsigned lsb, int64_t value)
+{
+        return Bitpack_inline_newu(word, width, lsb, (uint64_t)value);
+}
+
+#endif
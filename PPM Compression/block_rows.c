@@ -0,0 +1,566 @@
+/*
+ *      block_rows.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Implementation for the block_rows.h file. Functions in this file turn
+ *      two scanlines of scaled rgb integers into the quantized values of each
+ *      2x2 block in them. The scalar kernel calls the same row functions as
+ *      the full size pipeline. The SSE2 and AVX2 kernels do 4 or 8 blocks at a
+ *      time and repeat every scalar step in the same order and precision:
+ *      Y, Pb and Pr are weighed in double and rounded to float, and the sums
+ *      for a, b, c, d and the chroma averages are float sums in the order of
+ *      calc_a to calc_index_pr. Truncating is a min then a max, which keeps
+ *      what truncate returns, and converting to an integer rounds toward
+ *      zero like a cast. So every kernel gives the same bits. The code is
+ *      built without -mavx2; the AVX2 kernel is compiled for AVX2 on its own
+ *      and only picked when the CPU supports it
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "block_rows.h"
+#include "rgb_conversion.h"
+#include "rgb_yPbPr_conversion.h"
+#include "merge_blocks.h"
+#include "chroma.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BLOCK_ROWS_X86 1
+#include <immintrin.h>
+#endif
+
+typedef void block_row_kernel(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                              float denominator, block_row_planes planes,
+                              quantized_values row);
+
+void scalar_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                      float denominator, block_row_planes planes,
+                      quantized_values row);
+
+/* Kernel compress_block_row runs, picked on its first call if not set */
+static block_row_kernel *kernel = NULL;
+
+/* Weights of r, g, b in Y, Pb and Pr, as in calc_y, calc_pb and calc_pr */
+static const double Y_R = 0.299, Y_G = 0.587, Y_B = 0.114;
+static const double PB_R = -0.168736, PB_G = -0.331264, PB_B = 0.5;
+static const double PR_R = 0.5, PR_G = -0.418688, PR_B = -0.081312;
+
+/* Ranges and scale factors of merge_blocks.c */
+static const float Y_MAX = 1.0;
+static const float Y_MIN = 0.0;
+static const float PB_PR_RANGE = 0.5;
+static const float B_C_D_MAX = 0.3;
+static const float A_SCALE_FACTOR = 511.0;
+static const float B_C_D_SCALE_FACTOR = 50.0;
+
+/* Blocks per step of the SIMD kernels */
+#define SSE2_BLOCKS 4
+#define AVX2_BLOCKS 8
+
+
+/*************************** compress_block_row *******************************
+ *
+ * Computes the quantized values of the 2x2 blocks in two scanlines
+ *
+ * Inputs:
+ *              Pnm_rgb top: the upper scanline, two pixels per block
+ *              Pnm_rgb bottom: the lower scanline, two pixels per block
+ *              unsigned blocks: the number of blocks to compute
+ *              float denominator: the denominator of the image
+ *              block_row_planes planes: scratch planes from
+ *                                       block_row_planes_new
+ *              quantized_values row: array of blocks quantized values to fill
+ * Return:
+ *              none - the quantized values are stored in row
+ * Expects:
+ *              top, bottom, planes and row are not null
+ *              planes to have room for blocks blocks
+ *              every rgb value to be at most the denominator
+ * Notes:
+ *              will CRE if expectations fail
+ *              runs the kernel chosen with use_block_row_kernel, or else the
+ *                      fastest one the CPU supports
+ *
+ *****************************************************************************/
+void compress_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                        float denominator, block_row_planes planes,
+                        quantized_values row)
+{
+        assert(top != NULL && bottom != NULL && row != NULL);
+        assert(planes != NULL && blocks <= planes->blocks);
+
+        choose_block_row_kernel();
+        kernel(top, bottom, blocks, denominator, planes, row);
+}
+
+/************************** block_row_planes_new ******************************
+ *
+ * Makes the scratch planes compress_block_row converts rows of blocks in
+ *
+ * Inputs:
+ *              unsigned blocks: the most blocks in a row to be compressed
+ * Return:
+ *              the planes, which must be freed with block_row_planes_free
+ * Expects:
+ *              none
+ * Notes:
+ *              will CRE if memory cannot be allocated
+ *              one set of planes serves every row of an image on one thread
+ *
+ *****************************************************************************/
+block_row_planes block_row_planes_new(unsigned blocks)
+{
+        block_row_planes planes = malloc(sizeof(*planes));
+        assert(planes != NULL);
+
+        planes->blocks = blocks;
+        planes->rgb = planar_new(2 * blocks, 2);
+        planes->component = planar_new(2 * blocks, 2);
+
+        return planes;
+}
+
+/************************** block_row_planes_free *****************************
+ *
+ * Frees the planes made by block_row_planes_new
+ *
+ * Inputs:
+ *              block_row_planes *planes: pointer to the planes to free
+ * Return:
+ *              none - *planes is set to NULL
+ * Expects:
+ *              planes and *planes are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void block_row_planes_free(block_row_planes *planes)
+{
+        assert(planes != NULL && *planes != NULL);
+
+        planar_free(&(*planes)->rgb);
+        planar_free(&(*planes)->component);
+        free(*planes);
+        *planes = NULL;
+}
+
+/************************** choose_block_row_kernel ***************************
+ *
+ * Chooses the fastest kernel the CPU supports, unless use_block_row_kernel
+ * already chose one
+ *
+ * Inputs:
+ *              none
+ * Return:
+ *              none
+ * Expects:
+ *              none
+ * Notes:
+ *              compress_block_row calls this, but threads that share the
+ *                      kernel should have it called before they start
+ *
+ *****************************************************************************/
+void choose_block_row_kernel(void)
+{
+        if (kernel == NULL) {
+                bool picked = use_block_row_kernel("avx2") ||
+                              use_block_row_kernel("sse2") ||
+                              use_block_row_kernel("scalar");
+                assert(picked);
+        }
+}
+
+/****************************** scalar_block_row ******************************
+ *
+ * Scalar kernel - converts the scanlines to two rows of planar images and
+ * quantizes them with the row functions of the full size pipeline
+ *
+ * Inputs and Expects are those of compress_block_row
+ * Notes:
+ *              the planes are used with their width set to the blocks of
+ *                      this call, which may be fewer than they have room for
+ *
+ *****************************************************************************/
+void scalar_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                      float denominator, block_row_planes planes,
+                      quantized_values row)
+{
+        planar_image rgb = planes->rgb;
+        planar_image component = planes->component;
+        rgb->width = component->width = 2 * blocks;
+
+        rgb_row_to_planar(top, denominator, rgb, 0);
+        rgb_row_to_planar(bottom, denominator, rgb, 1);
+        rgb_to_component_row(rgb, component, 0);
+        rgb_to_component_row(rgb, component, 1);
+        merge_block_row(component, 0, row);
+}
+
+#ifdef BLOCK_ROWS_X86
+
+/* Y, Pb and Pr of the four pixels of 4 blocks, one float per block */
+struct sse2_pixels {
+        __m128 y[4], pb[4], pr[4];
+};
+
+/* Y, Pb and Pr of the four pixels of 8 blocks, one float per block */
+struct avx2_pixels {
+        __m256 y[4], pb[4], pr[4];
+};
+
+/*************************** store_quantized **********************************
+ *
+ * SIMD kernel helper function - stores the a, b, c, d values and chroma
+ * averages the kernels computed for n blocks in row
+ *
+ * Inputs:
+ *              int *a, *b, *c, *d: the quantized values of each block
+ *              float *pb, *pr: the averaged Pb and Pr of each block
+ *              int n: the number of blocks
+ *              quantized_values row: where the quantized values are stored
+ * Return:
+ *              none - the quantized values are stored in row
+ * Expects:
+ *              none
+ * Notes:
+ *              the chroma indices come from index_of_chroma, one block at
+ *                      a time, as in calc_index_pb
+ *
+ *****************************************************************************/
+static void store_quantized(int *a, int *b, int *c, int *d, float *pb,
+                            float *pr, int n, quantized_values row)
+{
+        for (int i = 0; i < n; i++) {
+                row[i].a = (unsigned)a[i];
+                row[i].b = b[i];
+                row[i].c = c[i];
+                row[i].d = d[i];
+                row[i].index_pb = index_of_chroma(pb[i]);
+                row[i].index_pr = index_of_chroma(pr[i]);
+        }
+}
+
+/***************************** SSE2 kernel ************************************/
+
+/* Loads one channel of pixels 0, 2, 4 and 6 of a scanline as unscaled
+   floats, and marks in *over the lanes above 1 */
+static inline __m128 load_sse2(Pnm_rgb pixels, int channel, __m128 denominator,
+                               __m128 *over)
+{
+        const unsigned *p = &pixels->red + channel;
+        unsigned stride = 2 * sizeof(struct Pnm_rgb) / sizeof(unsigned);
+        __m128i v = _mm_set_epi32(p[3 * stride], p[2 * stride], p[stride],
+                                  p[0]);
+        __m128 f = _mm_div_ps(_mm_cvtepi32_ps(v), denominator);
+        *over = _mm_or_ps(*over, _mm_cmpgt_ps(f, _mm_set1_ps(1.0)));
+        return f;
+}
+
+/* Weighs r, g and b in double, (wr * r + wg * g) + wb * b, and rounds the
+   result to float, as calc_y, calc_pb and calc_pr do */
+static inline __m128 weigh_sse2(__m128 r, __m128 g, __m128 b, double wr,
+                                double wg, double wb)
+{
+        __m128d half[2];
+        __m128 channel[3] = {r, g, b};
+        __m128d lo[3], hi[3];
+
+        for (int i = 0; i < 3; i++) {
+                lo[i] = _mm_cvtps_pd(channel[i]);
+                hi[i] = _mm_cvtps_pd(_mm_movehl_ps(channel[i], channel[i]));
+        }
+        half[0] = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(wr), lo[0]),
+                                        _mm_mul_pd(_mm_set1_pd(wg), lo[1])),
+                             _mm_mul_pd(_mm_set1_pd(wb), lo[2]));
+        half[1] = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(wr), hi[0]),
+                                        _mm_mul_pd(_mm_set1_pd(wg), hi[1])),
+                             _mm_mul_pd(_mm_set1_pd(wb), hi[2]));
+        return _mm_movelh_ps(_mm_cvtpd_ps(half[0]), _mm_cvtpd_ps(half[1]));
+}
+
+/* Truncates to min..max, giving what truncate gives */
+static inline __m128 truncate_sse2(__m128 v, float min, float max)
+{
+        return _mm_max_ps(_mm_set1_ps(min), _mm_min_ps(_mm_set1_ps(max), v));
+}
+
+/* Scales a value of calc_b, calc_c or calc_d from its float sum */
+static inline __m128i scale_bcd_sse2(__m128 sum)
+{
+        __m128 v = _mm_mul_ps(sum, _mm_set1_ps(0.25));
+        v = truncate_sse2(v, -B_C_D_MAX, B_C_D_MAX);
+        return _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps(B_C_D_SCALE_FACTOR)));
+}
+
+/* Quantizes 4 blocks from the Y, Pb and Pr of their pixels */
+static void quantize_sse2(struct sse2_pixels *p, quantized_values row)
+{
+        __m128 *y = p->y;
+        int a[SSE2_BLOCKS], b[SSE2_BLOCKS], c[SSE2_BLOCKS], d[SSE2_BLOCKS];
+        float pb[SSE2_BLOCKS], pr[SSE2_BLOCKS];
+
+        /* Truncate as merge_block does */
+        for (int i = 0; i < 4; i++) {
+                y[i] = truncate_sse2(y[i], Y_MIN, Y_MAX);
+                p->pb[i] = truncate_sse2(p->pb[i], -PB_PR_RANGE, PB_PR_RANGE);
+                p->pr[i] = truncate_sse2(p->pr[i], -PB_PR_RANGE, PB_PR_RANGE);
+        }
+
+        /* calc_a: (y4 + y3 + y2 + y1) / 4 */
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(y[3], y[2]), y[1]),
+                                y[0]);
+        sum = _mm_mul_ps(_mm_mul_ps(sum, _mm_set1_ps(0.25)),
+                         _mm_set1_ps(A_SCALE_FACTOR));
+        _mm_storeu_si128((__m128i *)a, _mm_cvttps_epi32(sum));
+
+        /* calc_b, calc_c, calc_d */
+        sum = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(y[3], y[2]), y[1]), y[0]);
+        _mm_storeu_si128((__m128i *)b, scale_bcd_sse2(sum));
+        sum = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(y[3], y[2]), y[1]), y[0]);
+        _mm_storeu_si128((__m128i *)c, scale_bcd_sse2(sum));
+        sum = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(y[3], y[2]), y[1]), y[0]);
+        _mm_storeu_si128((__m128i *)d, scale_bcd_sse2(sum));
+
+        /* calc_index_pb and calc_index_pr average in the order 1 to 4 */
+        sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(p->pb[0], p->pb[1]), p->pb[2]),
+                         p->pb[3]);
+        _mm_storeu_ps(pb, _mm_mul_ps(sum, _mm_set1_ps(0.25)));
+        sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(p->pr[0], p->pr[1]), p->pr[2]),
+                         p->pr[3]);
+        _mm_storeu_ps(pr, _mm_mul_ps(sum, _mm_set1_ps(0.25)));
+
+        store_quantized(a, b, c, d, pb, pr, SSE2_BLOCKS, row);
+}
+
+/****************************** sse2_block_row ********************************
+ *
+ * SSE2 kernel - computes 4 blocks at a time, and any blocks left over with
+ * the scalar kernel
+ *
+ * Inputs and Expects are those of compress_block_row
+ *
+ *****************************************************************************/
+static void sse2_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                           float denominator, block_row_planes planes,
+                           quantized_values row)
+{
+        __m128 d = _mm_set1_ps(denominator);
+        __m128 over = _mm_setzero_ps();
+        unsigned i;
+
+        for (i = 0; i + SSE2_BLOCKS <= blocks; i += SSE2_BLOCKS) {
+                /* The four pixels of each block, as in merge_block */
+                Pnm_rgb pixels[4] = {&top[2 * i], &top[2 * i + 1],
+                                     &bottom[2 * i], &bottom[2 * i + 1]};
+                struct sse2_pixels p;
+                for (int k = 0; k < 4; k++) {
+                        __m128 r = load_sse2(pixels[k], 0, d, &over);
+                        __m128 g = load_sse2(pixels[k], 1, d, &over);
+                        __m128 b = load_sse2(pixels[k], 2, d, &over);
+                        p.y[k] = weigh_sse2(r, g, b, Y_R, Y_G, Y_B);
+                        p.pb[k] = weigh_sse2(r, g, b, PB_R, PB_G, PB_B);
+                        p.pr[k] = weigh_sse2(r, g, b, PR_R, PR_G, PR_B);
+                }
+                quantize_sse2(&p, &row[i]);
+        }
+        assert(_mm_movemask_ps(over) == 0);
+
+        if (i < blocks) {
+                scalar_block_row(&top[2 * i], &bottom[2 * i], blocks - i,
+                                 denominator, planes, &row[i]);
+        }
+}
+
+/***************************** AVX2 kernel ************************************/
+
+#define AVX2 __attribute__((target("avx2")))
+
+/* Loads one channel of pixels 0, 2, ..., 14 of a scanline as unscaled
+   floats, and marks in *over the lanes above 1 */
+static inline AVX2 __m256 load_avx2(Pnm_rgb pixels, int channel,
+                                    __m256 denominator, __m256 *over)
+{
+        const int *p = (const int *)&pixels->red + channel;
+        int stride = 2 * sizeof(struct Pnm_rgb) / sizeof(unsigned);
+        __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4,
+                                                             5, 6, 7),
+                                           _mm256_set1_epi32(stride));
+        __m256i v = _mm256_i32gather_epi32(p, index, sizeof(int));
+        __m256 f = _mm256_div_ps(_mm256_cvtepi32_ps(v), denominator);
+        *over = _mm256_or_ps(*over, _mm256_cmp_ps(f, _mm256_set1_ps(1.0),
+                                                  _CMP_GT_OQ));
+        return f;
+}
+
+/* Weighs r, g and b in double, (wr * r + wg * g) + wb * b, and rounds the
+   result to float, as calc_y, calc_pb and calc_pr do */
+static inline AVX2 __m256 weigh_avx2(__m256 r, __m256 g, __m256 b, double wr,
+                                     double wg, double wb)
+{
+        __m128 half[2];
+        __m256 channel[3] = {r, g, b};
+
+        for (int h = 0; h < 2; h++) {
+                __m256d v[3];
+                for (int i = 0; i < 3; i++) {
+                        __m128 part = h == 0 ?
+                                _mm256_castps256_ps128(channel[i]) :
+                                _mm256_extractf128_ps(channel[i], 1);
+                        v[i] = _mm256_cvtps_pd(part);
+                }
+                __m256d sum = _mm256_add_pd(
+                        _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(wr), v[0]),
+                                      _mm256_mul_pd(_mm256_set1_pd(wg), v[1])),
+                        _mm256_mul_pd(_mm256_set1_pd(wb), v[2]));
+                half[h] = _mm256_cvtpd_ps(sum);
+        }
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(half[0]), half[1],
+                                    1);
+}
+
+/* Truncates to min..max, giving what truncate gives */
+static inline AVX2 __m256 truncate_avx2(__m256 v, float min, float max)
+{
+        return _mm256_max_ps(_mm256_set1_ps(min),
+                             _mm256_min_ps(_mm256_set1_ps(max), v));
+}
+
+/* Scales a value of calc_b, calc_c or calc_d from its float sum */
+static inline AVX2 __m256i scale_bcd_avx2(__m256 sum)
+{
+        __m256 v = _mm256_mul_ps(sum, _mm256_set1_ps(0.25));
+        v = truncate_avx2(v, -B_C_D_MAX, B_C_D_MAX);
+        v = _mm256_mul_ps(v, _mm256_set1_ps(B_C_D_SCALE_FACTOR));
+        return _mm256_cvttps_epi32(v);
+}
+
+/* Quantizes 8 blocks from the Y, Pb and Pr of their pixels */
+static AVX2 void quantize_avx2(struct avx2_pixels *p, quantized_values row)
+{
+        __m256 *y = p->y;
+        int a[AVX2_BLOCKS], b[AVX2_BLOCKS], c[AVX2_BLOCKS], d[AVX2_BLOCKS];
+        float pb[AVX2_BLOCKS], pr[AVX2_BLOCKS];
+
+        /* Truncate as merge_block does */
+        for (int i = 0; i < 4; i++) {
+                y[i] = truncate_avx2(y[i], Y_MIN, Y_MAX);
+                p->pb[i] = truncate_avx2(p->pb[i], -PB_PR_RANGE, PB_PR_RANGE);
+                p->pr[i] = truncate_avx2(p->pr[i], -PB_PR_RANGE, PB_PR_RANGE);
+        }
+
+        /* calc_a: (y4 + y3 + y2 + y1) / 4 */
+        __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(y[3], y[2]),
+                                                 y[1]), y[0]);
+        sum = _mm256_mul_ps(_mm256_mul_ps(sum, _mm256_set1_ps(0.25)),
+                            _mm256_set1_ps(A_SCALE_FACTOR));
+        _mm256_storeu_si256((__m256i *)a, _mm256_cvttps_epi32(sum));
+
+        /* calc_b, calc_c, calc_d */
+        sum = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(y[3], y[2]), y[1]),
+                            y[0]);
+        _mm256_storeu_si256((__m256i *)b, scale_bcd_avx2(sum));
+        sum = _mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(y[3], y[2]), y[1]),
+                            y[0]);
+        _mm256_storeu_si256((__m256i *)c, scale_bcd_avx2(sum));
+        sum = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(y[3], y[2]), y[1]),
+                            y[0]);
+        _mm256_storeu_si256((__m256i *)d, scale_bcd_avx2(sum));
+
+        /* calc_index_pb and calc_index_pr average in the order 1 to 4 */
+        sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(p->pb[0], p->pb[1]),
+                                          p->pb[2]), p->pb[3]);
+        _mm256_storeu_ps(pb, _mm256_mul_ps(sum, _mm256_set1_ps(0.25)));
+        sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(p->pr[0], p->pr[1]),
+                                          p->pr[2]), p->pr[3]);
+        _mm256_storeu_ps(pr, _mm256_mul_ps(sum, _mm256_set1_ps(0.25)));
+
+        store_quantized(a, b, c, d, pb, pr, AVX2_BLOCKS, row);
+}
+
+/****************************** avx2_block_row ********************************
+ *
+ * AVX2 kernel - computes 8 blocks at a time, and any blocks left over with
+ * the SSE2 kernel
+ *
+ * Inputs and Expects are those of compress_block_row
+ *
+ *****************************************************************************/
+static AVX2 void avx2_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                                float denominator, block_row_planes planes,
+                                quantized_values row)
+{
+        __m256 d = _mm256_set1_ps(denominator);
+        __m256 over = _mm256_setzero_ps();
+        unsigned i;
+
+        for (i = 0; i + AVX2_BLOCKS <= blocks; i += AVX2_BLOCKS) {
+                /* The four pixels of each block, as in merge_block */
+                Pnm_rgb pixels[4] = {&top[2 * i], &top[2 * i + 1],
+                                     &bottom[2 * i], &bottom[2 * i + 1]};
+                struct avx2_pixels p;
+                for (int k = 0; k < 4; k++) {
+                        __m256 r = load_avx2(pixels[k], 0, d, &over);
+                        __m256 g = load_avx2(pixels[k], 1, d, &over);
+                        __m256 b = load_avx2(pixels[k], 2, d, &over);
+                        p.y[k] = weigh_avx2(r, g, b, Y_R, Y_G, Y_B);
+                        p.pb[k] = weigh_avx2(r, g, b, PB_R, PB_G, PB_B);
+                        p.pr[k] = weigh_avx2(r, g, b, PR_R, PR_G, PR_B);
+                }
+                quantize_avx2(&p, &row[i]);
+        }
+        assert(_mm256_movemask_ps(over) == 0);
+
+        if (i < blocks) {
+                sse2_block_row(&top[2 * i], &bottom[2 * i], blocks - i,
+                               denominator, planes, &row[i]);
+        }
+}
+
+#endif /* BLOCK_ROWS_X86 */
+
+/*************************** use_block_row_kernel *****************************
+ *
+ * Chooses the kernel compress_block_row runs
+ *
+ * Inputs:
+ *              const char *name: "scalar", "sse2" or "avx2"
+ * Return:
+ *              true if the kernel was chosen, false if there is no kernel
+ *              called name or the CPU does not support it
+ * Expects:
+ *              name is not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+bool use_block_row_kernel(const char *name)
+{
+        assert(name != NULL);
+
+        /* The scalar steps read a Pnm_rgb as three unsigned values */
+        assert(sizeof(struct Pnm_rgb) == 3 * sizeof(unsigned));
+
+        if (strcmp(name, "scalar") == 0) {
+                kernel = scalar_block_row;
+                return true;
+        }
+#ifdef BLOCK_ROWS_X86
+        if (strcmp(name, "sse2") == 0) {
+                kernel = sse2_block_row;
+                return true;
+        }
+        if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+                kernel = avx2_block_row;
+                return true;
+        }
+#endif
+        return false;
+}
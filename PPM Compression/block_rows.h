@@ -0,0 +1,39 @@
+/*
+ *      block_rows.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Interface for the block_rows.c file. Functions in this file turn two
+ *      scanlines of scaled rgb integers into the quantized values of each 2x2
+ *      block in them, with a scalar, an SSE2 or an AVX2 kernel
+ */
+
+#ifndef BLOCK_ROWS_INCLUDED
+#define BLOCK_ROWS_INCLUDED
+
+/* Standard C Libraries */
+#include <stdbool.h>
+
+/* CS40 Libraries */
+#include <pnm.h>
+
+/* Custom .h files */
+#include "compress_structs.h"
+#include "planar.h"
+
+/* Planes the scalar kernel converts up to blocks blocks in, made once for
+   each image and each thread that compresses rows of it */
+typedef struct block_row_planes {
+        unsigned blocks;
+        planar_image rgb, component;
+} *block_row_planes;
+
+extern block_row_planes block_row_planes_new(unsigned blocks);
+extern void block_row_planes_free(block_row_planes *planes);
+extern void compress_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                               float denominator, block_row_planes planes,
+                               quantized_values row);
+extern bool use_block_row_kernel(const char *name);
+extern void choose_block_row_kernel(void);
+
+#endif
@@ -0,0 +1,340 @@
+/*
+ *      chroma.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Implementation for the chroma.h file. Arith40 picks the closest of
+ *      16 chroma values, so its index only goes up as the chroma goes up.
+ *      build_chroma_tables finds, for each index, the smallest float in
+ *      -0.5 to 0.5 that Arith40 gives that index or a larger one for, and
+ *      splits -0.5 to 0.5 into CHROMA_BINS bins that each know the index
+ *      a little before their start. A lookup finds the bin of a chroma and
+ *      moves up past any of those smallest floats at or below it, which
+ *      takes at most one step when the 16 chroma values are more than two
+ *      bins apart. The decompression table holds the 16 chroma values
+ *      already truncated to -0.5 to 0.5
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+/* CS40 Libraries */
+#include <arith40.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "chroma.h"
+
+/* Number of chroma indices */
+#define CHROMA_INDICES 16
+
+/* Number of bins -0.5 to 0.5 is split into */
+#define CHROMA_BINS 1024
+
+/* Fixed point Pb and Pr values are in units of 1 / CHROMA_FIXED_ONE */
+#define CHROMA_FIXED_ONE 65536
+
+/* Range of the Pb and Pr values that are quantized */
+static const float PB_PR_RANGE = 0.5;
+
+/* threshold[i] is the smallest chroma whose index is at least i, or
+   INFINITY if no chroma up to 0.5 has an index that large */
+static float threshold[CHROMA_INDICES];
+
+/* The index of a chroma a little below the start of each bin */
+static unsigned char bin_index[CHROMA_BINS];
+
+/* Chroma of each index, truncated to -0.5 to 0.5 */
+static float chroma_value[CHROMA_INDICES];
+
+/* The same as fixed point values */
+static int fixed_chroma_value[CHROMA_INDICES];
+
+/* The index of every fixed point chroma from -0.5 to 0.5, from -0.5 up */
+static unsigned char fixed_index[CHROMA_FIXED_ONE + 1];
+
+float first_chroma_with_index(unsigned index);
+unsigned count_thresholds(float chroma);
+
+
+/*************************** build_chroma_tables ******************************
+ *
+ * Builds the tables index_of_chroma and chroma_of_index look values up in
+ *
+ * Inputs:
+ *              none
+ * Return:
+ *              none
+ * Expects:
+ *              none
+ * Notes:
+ *              40image calls this once at startup, before any thread starts
+ *              calls Arith40_index_of_chroma a few thousand times
+ *
+ *****************************************************************************/
+void build_chroma_tables(void)
+{
+        threshold[0] = -INFINITY;
+        for (unsigned i = 1; i < CHROMA_INDICES; i++) {
+                threshold[i] = first_chroma_with_index(i);
+        }
+
+        /* Start one bin early, well below any rounding of a bin's start */
+        for (int bin = 0; bin < CHROMA_BINS; bin++) {
+                float start = -PB_PR_RANGE + (float)(bin - 1) / CHROMA_BINS;
+                bin_index[bin] = count_thresholds(start);
+        }
+
+        /* Truncate the way split_block truncated Arith40_chroma_of_index */
+        for (unsigned i = 0; i < CHROMA_INDICES; i++) {
+                float value = Arith40_chroma_of_index(i);
+                if (!(value >= -PB_PR_RANGE && value <= PB_PR_RANGE)) {
+                        value = value > PB_PR_RANGE ? PB_PR_RANGE
+                                                    : -PB_PR_RANGE;
+                }
+                chroma_value[i] = value;
+                fixed_chroma_value[i] = lroundf(value * CHROMA_FIXED_ONE);
+        }
+
+        for (int i = 0; i <= CHROMA_FIXED_ONE; i++) {
+                int fixed = i - CHROMA_FIXED_ONE / 2;
+                fixed_index[i] = index_of_chroma((float)fixed / 
+                                                 CHROMA_FIXED_ONE);
+        }
+}
+
+/***************************** index_of_chroma ********************************
+ *
+ * Quantizes an averaged Pb or Pr value to its 4 bit index
+ *
+ * Inputs:
+ *              float chroma: the Pb or Pr value
+ * Return:
+ *              the index Arith40_index_of_chroma gives for chroma
+ * Expects:
+ *              chroma in the range -0.5 to 0.5
+ *              build_chroma_tables has been called
+ * Notes:
+ *              check_chroma_tables confirms the index for every float in
+ *                      the range
+ *
+ *****************************************************************************/
+unsigned index_of_chroma(float chroma)
+{
+        /* Outside the range, and NaN, go to the first or last bin */
+        float position = (chroma + PB_PR_RANGE) * CHROMA_BINS;
+        int bin = 0;
+        if (position >= CHROMA_BINS) {
+                bin = CHROMA_BINS - 1;
+        } else if (position > 0) {
+                bin = (int)position;
+        }
+
+        unsigned index = bin_index[bin];
+        while (index + 1 < CHROMA_INDICES && chroma >= threshold[index + 1]) {
+                index++;
+        }
+
+        return index;
+}
+
+/***************************** chroma_of_index ********************************
+ *
+ * Gives the Pb or Pr value of a 4 bit index
+ *
+ * Inputs:
+ *              unsigned index: the index
+ * Return:
+ *              Arith40_chroma_of_index(index) truncated to -0.5 to 0.5
+ * Expects:
+ *              index to be less than 16
+ *              build_chroma_tables has been called
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+float chroma_of_index(unsigned index)
+{
+        assert(index < CHROMA_INDICES);
+
+        return chroma_value[index];
+}
+
+/************************** index_of_fixed_chroma *****************************
+ *
+ * Quantizes an averaged fixed point Pb or Pr value to its 4 bit index
+ *
+ * Inputs:
+ *              int chroma: the Pb or Pr value in units of 1 / 65536
+ * Return:
+ *              the index index_of_chroma gives for chroma / 65536
+ * Expects:
+ *              chroma in the range -32768 to 32768
+ *              build_chroma_tables has been called
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+unsigned index_of_fixed_chroma(int chroma)
+{
+        assert(chroma >= -CHROMA_FIXED_ONE / 2 && 
+               chroma <= CHROMA_FIXED_ONE / 2);
+
+        return fixed_index[chroma + CHROMA_FIXED_ONE / 2];
+}
+
+/************************** fixed_chroma_of_index *****************************
+ *
+ * Gives the fixed point Pb or Pr value of a 4 bit index
+ *
+ * Inputs:
+ *              unsigned index: the index
+ * Return:
+ *              chroma_of_index(index) in units of 1 / 65536, rounded
+ * Expects:
+ *              index to be less than 16
+ *              build_chroma_tables has been called
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+int fixed_chroma_of_index(unsigned index)
+{
+        assert(index < CHROMA_INDICES);
+
+        return fixed_chroma_value[index];
+}
+
+/*************************** check_chroma_tables ******************************
+ *
+ * Compares the tables with Arith40 for every float from -0.5 to 0.5 and for
+ * every index, and prints each difference to stderr
+ *
+ * Inputs:
+ *              none
+ * Return:
+ *              the number of floats and indices that gave a different value
+ * Expects:
+ *              build_chroma_tables has been called
+ * Notes:
+ *              run by 40image --check-chroma; calls Arith40_index_of_chroma
+ *                      about two billion times
+ *
+ *****************************************************************************/
+unsigned long check_chroma_tables(void)
+{
+        unsigned long differences = 0;
+
+        /* Floats of each sign are in order of their bits, from zero up to
+           0.5, which is 0x3f000000 */
+        const uint32_t HALF_BITS = 0x3f000000;
+        const uint32_t SIGN_BIT = 0x80000000;
+        for (int sign = 0; sign < 2; sign++) {
+                for (uint32_t bits = 0; bits <= HALF_BITS; bits++) {
+                        uint32_t signed_bits = sign ? bits | SIGN_BIT : bits;
+                        float value;
+                        memcpy(&value, &signed_bits, sizeof(value));
+                        unsigned expected = Arith40_index_of_chroma(value);
+                        if (index_of_chroma(value) != expected) {
+                                fprintf(stderr, "chroma %a: index %u, "
+                                        "Arith40 gives %u\n", value,
+                                        index_of_chroma(value), expected);
+                                differences++;
+                        }
+                }
+        }
+
+        for (unsigned i = 0; i < CHROMA_INDICES; i++) {
+                float value = Arith40_chroma_of_index(i);
+                if (value > PB_PR_RANGE) {
+                        value = PB_PR_RANGE;
+                } else if (!(value >= -PB_PR_RANGE)) {
+                        value = -PB_PR_RANGE;
+                }
+                if (memcmp(&value, &chroma_value[i], sizeof(value)) != 0) {
+                        fprintf(stderr, "index %u: chroma %a, Arith40 "
+                                "gives %a\n", i, chroma_value[i], value);
+                        differences++;
+                }
+        }
+
+        return differences;
+}
+
+/************************* first_chroma_with_index ****************************
+ *
+ * build_chroma_tables helper function - finds the smallest float from -0.5
+ * to 0.5 that Arith40_index_of_chroma gives index or a larger one for
+ *
+ * Inputs:
+ *              unsigned index: the index, 1 to 15
+ * Return:
+ *              the smallest such float, or INFINITY if there is none
+ * Expects:
+ *              Arith40_index_of_chroma never gives a smaller index for a
+ *              larger float
+ * Notes:
+ *              halves the range between a float whose index is smaller and
+ *                      one whose index is not until they are neighbours
+ *
+ *****************************************************************************/
+float first_chroma_with_index(unsigned index)
+{
+        float low = -PB_PR_RANGE;
+        float high = PB_PR_RANGE;
+        if (Arith40_index_of_chroma(low) >= index) {
+                return low;
+        }
+        if (Arith40_index_of_chroma(high) < index) {
+                return INFINITY;
+        }
+
+        /* The index of low is too small and the index of high is not */
+        while (nextafterf(low, high) != high) {
+                float middle = low + (high - low) / 2;
+                if (middle <= low) {
+                        middle = nextafterf(low, high);
+                } else if (middle >= high) {
+                        middle = nextafterf(high, low);
+                }
+
+                if (Arith40_index_of_chroma(middle) >= index) {
+                        high = middle;
+                } else {
+                        low = middle;
+                }
+        }
+
+        return high;
+}
+
+/***************************** count_thresholds *******************************
+ *
+ * build_chroma_tables helper function - gives the index of a chroma from the
+ * thresholds alone
+ *
+ * Inputs:
+ *              float chroma: the chroma
+ * Return:
+ *              the number of thresholds after the first at or below chroma
+ * Expects:
+ *              the thresholds have been found
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+unsigned count_thresholds(float chroma)
+{
+        unsigned index = 0;
+        while (index + 1 < CHROMA_INDICES && chroma >= threshold[index + 1]) {
+                index++;
+        }
+
+        return index;
+}
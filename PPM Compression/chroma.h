@@ -0,0 +1,22 @@
+/*
+ *      chroma.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Interface for the chroma.c file. Functions in this file quantize
+ *      Pb and Pr averages to 4 bit indices and back with tables that give
+ *      the same values as Arith40_index_of_chroma and Arith40_chroma_of_index.
+ *      Fixed point values, in units of 1 / 65536, have tables of their own
+ */
+
+#ifndef CHROMA_INCLUDED
+#define CHROMA_INCLUDED
+
+extern void build_chroma_tables(void);
+extern unsigned index_of_chroma(float chroma);
+extern float chroma_of_index(unsigned index);
+extern unsigned index_of_fixed_chroma(int chroma);
+extern int fixed_chroma_of_index(unsigned index);
+extern unsigned long check_chroma_tables(void);
+
+#endif
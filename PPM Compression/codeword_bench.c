@@ -0,0 +1,334 @@
+/*
+ *      codeword_bench.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Times writing and reading the code words of an image through a file,
+ *      one word at a time with putc and getc, as final_bitpack.c did before
+ *      it wrote rows, and one row of blocks at a time with write_codeword_row
+ *      and read_codeword_row. Both paths pack with pack_fields and unpack
+ *      with unpack_fields, so only the I/O differs. The quantized values are
+ *      random but fixed, and every read is checked against what was written.
+ *
+ *      Usage: codeword_bench [-w width] [-h height] [-r rounds]
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+/* CS40 Libraries */
+#include <bitpack.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "compress_structs.h"
+#include "final_bitpack.h"
+
+/* Distinct rows of quantized values; row r of the image uses r % ROWS */
+#define ROWS 64
+
+/* A code word has four bytes of eight bits */
+#define BYTE_BITS 8
+
+
+/******************************** random_below ********************************
+ *
+ * Gives a pseudo-random number from a xorshift generator
+ *
+ * Inputs:
+ *              uint64_t *state: the state of the generator
+ *              unsigned bound: one more than the largest number wanted
+ * Return:
+ *              a number from 0 to bound - 1
+ * Expects:
+ *              state not to be null or point to 0, and bound to be more
+ *              than 0
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static unsigned random_below(uint64_t *state, unsigned bound)
+{
+        assert(state != NULL && *state != 0 && bound > 0);
+
+        *state ^= *state << 13;
+        *state ^= *state >> 7;
+        *state ^= *state << 17;
+        return *state % bound;
+}
+
+/******************************** write_word **********************************
+ *
+ * Writes a code word to a stream in big-endian order one byte at a time, as
+ * final_bitpack.c did before it wrote rows
+ *
+ * Inputs:
+ *              uint64_t word: the code word to write
+ *              FILE *output: the stream to write the code word to
+ * Return:
+ *              none - the code word is written to output using putc
+ * Expects:
+ *              output is not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static void write_word(uint64_t word, FILE *output)
+{
+        assert(output != NULL);
+
+        for (int i = CODEWORD_BYTES - 1; i >= 0; i--) {
+                putc(Bitpack_getu(word, BYTE_BITS, i * BYTE_BITS), output);
+        }
+}
+
+/********************************* read_word **********************************
+ *
+ * Reads a code word from a stream in big-endian order one byte at a time,
+ * as final_bitpack.c did before it read rows
+ *
+ * Inputs:
+ *              FILE *input: the stream to read the code word from
+ * Return:
+ *              the code word read
+ * Expects:
+ *              input not to be null and the stream to hold four more bytes
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static uint64_t read_word(FILE *input)
+{
+        assert(input != NULL);
+
+        uint64_t word = 0;
+        for (int i = CODEWORD_BYTES - 1; i >= 0; i--) {
+                int c = getc(input);
+                assert(c != EOF);
+                word = Bitpack_newu(word, BYTE_BITS, i * BYTE_BITS,
+                                    (uint64_t)c);
+        }
+
+        return word;
+}
+
+/********************************** sum_of ************************************
+ *
+ * Adds up the fields of one block's quantized values, so that what was read
+ * can be checked against what was written
+ *
+ * Inputs:
+ *              const struct quantized_values *q: the values
+ * Return:
+ *              the sum of the six fields
+ * Expects:
+ *              q not to be null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static uint64_t sum_of(const struct quantized_values *q)
+{
+        assert(q != NULL);
+
+        return q->a + q->index_pb + q->index_pr + (uint64_t)(int64_t)q->b +
+               (uint64_t)(int64_t)q->c + (uint64_t)(int64_t)q->d;
+}
+
+/********************************** seconds ***********************************
+ *
+ * Gives the time of a monotonic clock
+ *
+ * Inputs:
+ *              none
+ * Return:
+ *              the time in seconds
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static double seconds(void)
+{
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/******************************** time_write **********************************
+ *
+ * Writes the code words of an image to a file and times it
+ *
+ * Inputs:
+ *              FILE *file: the file, rewound first
+ *              struct quantized_values *values: ROWS rows of blocks values
+ *              unsigned blocks: blocks across a row
+ *              unsigned rows: rows of blocks in the image
+ *              bool by_rows: true to write with write_codeword_row, false
+ *                            to write one word at a time
+ *              unsigned char *buffer: room for a row of code words
+ * Return:
+ *              seconds taken, including the flush
+ * Expects:
+ *              file, values and buffer not to be null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static double time_write(FILE *file, struct quantized_values *values,
+                         unsigned blocks, unsigned rows, bool by_rows,
+                         unsigned char *buffer)
+{
+        assert(file != NULL && values != NULL && buffer != NULL);
+        rewind(file);
+
+        double start = seconds();
+        for (unsigned row = 0; row < rows; row++) {
+                quantized_values q = &values[(size_t)(row % ROWS) * blocks];
+                if (by_rows) {
+                        write_codeword_row(q, blocks, buffer, file);
+                        continue;
+                }
+                for (unsigned i = 0; i < blocks; i++) {
+                        write_word(pack_fields(&q[i]), file);
+                }
+        }
+        fflush(file);
+        return seconds() - start;
+}
+
+/********************************* time_read **********************************
+ *
+ * Reads the code words of an image back from a file, unpacks them and times
+ * it
+ *
+ * Inputs:
+ *              FILE *file: the file, rewound first
+ *              unsigned blocks: blocks across a row
+ *              unsigned rows: rows of blocks in the image
+ *              bool by_rows: true to read with read_codeword_row, false to
+ *                            read one word at a time
+ *              unsigned char *buffer: room for a row of code words
+ *              uint64_t *sum: where the sum of every unpacked field goes
+ * Return:
+ *              seconds taken
+ * Expects:
+ *              file, buffer and sum not to be null and the file to hold
+ *              blocks * rows code words
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static double time_read(FILE *file, unsigned blocks, unsigned rows,
+                        bool by_rows, unsigned char *buffer, uint64_t *sum)
+{
+        assert(file != NULL && buffer != NULL && sum != NULL);
+        rewind(file);
+
+        struct quantized_values q;
+        uint64_t total = 0;
+        double start = seconds();
+        for (unsigned row = 0; row < rows; row++) {
+                if (by_rows) {
+                        read_codeword_row(file, blocks, buffer);
+                }
+                for (unsigned i = 0; i < blocks; i++) {
+                        uint64_t word = by_rows ?
+                                load_codeword(&buffer[i * CODEWORD_BYTES]) :
+                                read_word(file);
+                        unpack_fields(word, &q);
+                        total += sum_of(&q);
+                }
+        }
+        double taken = seconds() - start;
+
+        *sum = total;
+        return taken;
+}
+
+int main(int argc, char *argv[])
+{
+        unsigned width = 6000, height = 4000, rounds = 5;
+        for (int i = 1; i < argc; i++) {
+                if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+                        width = strtoul(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-h") == 0 && i + 1 < argc) {
+                        height = strtoul(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+                        rounds = strtoul(argv[++i], NULL, 10);
+                } else {
+                        fprintf(stderr, "Usage: %s [-w width] [-h height] "
+                                "[-r rounds]\n", argv[0]);
+                        exit(1);
+                }
+        }
+        unsigned blocks = width / 2, rows = height / 2;
+        if (blocks == 0 || rows == 0 || rounds == 0) {
+                fprintf(stderr, "%s: the image needs a 2x2 block and a "
+                        "round\n", argv[0]);
+                exit(1);
+        }
+
+        /* ROWS rows of valid quantized values, and the sum a read gives */
+        struct quantized_values *values =
+                malloc((size_t)ROWS * blocks * sizeof(*values));
+        unsigned char *buffer = malloc((size_t)blocks * CODEWORD_BYTES);
+        FILE *file = tmpfile();
+        assert(values != NULL && buffer != NULL && file != NULL);
+        uint64_t state = 88172645463325252u;
+        for (size_t i = 0; i < (size_t)ROWS * blocks; i++) {
+                values[i].a = random_below(&state, 1u << A_WIDTH);
+                values[i].b = (int)random_below(&state, 31) - 15;
+                values[i].c = (int)random_below(&state, 31) - 15;
+                values[i].d = (int)random_below(&state, 31) - 15;
+                values[i].index_pb = random_below(&state, 1u << PB_WIDTH);
+                values[i].index_pr = random_below(&state, 1u << PR_WIDTH);
+        }
+        uint64_t expected = 0;
+        for (unsigned row = 0; row < rows; row++) {
+                for (unsigned i = 0; i < blocks; i++) {
+                        expected += sum_of(&values[(size_t)(row % ROWS) *
+                                                   blocks + i]);
+                }
+        }
+
+        /* best of rounds, the two paths taking turns */
+        double best[2][2] = { { 1e9, 1e9 }, { 1e9, 1e9 } };
+        for (unsigned round = 0; round < rounds; round++) {
+                for (int by_rows = 0; by_rows < 2; by_rows++) {
+                        double w = time_write(file, values, blocks, rows,
+                                              by_rows, buffer);
+                        uint64_t sum;
+                        double r = time_read(file, blocks, rows, by_rows,
+                                             buffer, &sum);
+                        assert(sum == expected);
+                        best[by_rows][0] = w < best[by_rows][0] ?
+                                           w : best[by_rows][0];
+                        best[by_rows][1] = r < best[by_rows][1] ?
+                                           r : best[by_rows][1];
+                }
+        }
+
+        double mb = (double)blocks * rows * CODEWORD_BYTES / 1e6;
+        printf("%.1f MB of code words (%ux%u image), best of %u\n", mb,
+               width, height, rounds);
+        printf("                per word              by rows\n");
+        for (int io = 0; io < 2; io++) {
+                printf("%-8s  %6.3f s %6.0f MB/s   %6.3f s %6.0f MB/s\n",
+                       io == 0 ? "write" : "read", best[0][io],
+                       mb / best[0][io], best[1][io], mb / best[1][io]);
+        }
+
+        fclose(file);
+        free(buffer);
+        free(values);
+        return EXIT_SUCCESS;
+}
@@ -44,9 +44,9 @@ void compress40(FILE *input)
         assert(input != NULL);
 
         Pnm_ppm image = read_ppm(input);
-        compress_rgb_conversion(image);
-        A2Methods_UArray2 pixels = compress_yPbPr_conversion(image);
-        A2Methods_UArray2 quantized = compress_merge(pixels);
+        planar_image rgb = compress_rgb_conversion(image);
+        planar_image component = compress_yPbPr_conversion(rgb);
+        A2Methods_UArray2 quantized = compress_merge(component);
         compress_bitpack(quantized);
 }
 
@@ -8,8 +8,12 @@
  *      used to convert between 32 bit bitpacks and quantized values
  */
 
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
 /* CS40 Libraries */
-#include <bitpack.h>
 #include <a2plain.h>
 
 /* Hanson Libraries */
@@ -19,52 +23,26 @@
 #include "final_bitpack.h"
 #include "compress_structs.h"
 
-/* Width (in bits) of a subword in bitpack */
-const unsigned A_WIDTH = 9;
-
-/* Lowest significant bit of a subword in bitpack */
-const unsigned A_LSB = 23;
-
-/* Width (in bits) of b subword in bitpack */
-const unsigned B_WIDTH = 5;
-
-/* Lowest significant bit of b subword in bitpack */
-const unsigned B_LSB = 18;
-
-/* Width (in bits) of c subword in bitpack */
-const unsigned C_WIDTH = 5;
-
-/* Lowest significant bit of c subword in bitpack */
-const unsigned C_LSB = 13;
-
-/* Width (in bits) of d subword in bitpack */
-const unsigned D_WIDTH = 5;
-
-/* Lowest significant bit of d subword in bitpack */
-const unsigned D_LSB = 8;
-
-/* Width (in bits) of pb subword in bitpack */
-const unsigned PB_WIDTH = 4;
-
-/* Lowest significant bit of pb subword in bitpack */
-const unsigned PB_LSB = 4;
-
-/* Width (in bits) of pr subword in bitpack */
-const unsigned PR_WIDTH = 4;
-
-/* Lowest significant bit of pr subword in bitpack */
-const unsigned PR_LSB = 0;
-
 void compress_bitpack_apply(int col, int row, A2Methods_UArray2 array2, 
-                            void *elem, void *cl);
+                            void *elem, void *row_buffer);
 
 void decompress_word_apply(int col, int row, A2Methods_UArray2 array2, 
-                            void *elem, void *input);
+                            void *elem, void *row_buffer);
 
 void decompress_bitpack_apply(int col, int row, A2Methods_UArray2 array2, 
                             void *elem, void *code_words);
 
 
+/**********struct row_buffer********
+ * About: This struct holds the bytes of one row of code words and the file
+ *        they are written to or read from, so that the mapping functions
+ *        can write or read a whole row at a time
+************************/
+struct row_buffer {
+        unsigned char *bytes;
+        FILE *file;
+};
+
 /***************************** compress_bitpack *******************************
  *
  * Compresses quantized values in each pixel to 32 bit code words and prints 
@@ -98,9 +76,15 @@ void compress_bitpack(A2Methods_UArray2 quantized_pixels)
         /* Print output header */
         printf("COMP40 Compressed image format 2\n%u %u\n", width, height);
 
-        /* Compress quantized values to code words and free the UArray2 */
-        methods->map_row_major(quantized_pixels, compress_bitpack_apply, NULL);
+        /* Compress quantized values to code words one row at a time and free
+           the UArray2 */
+        struct row_buffer buffer = {malloc(width / 2 * CODEWORD_BYTES + 1),
+                                    stdout};
+        assert(buffer.bytes != NULL);
+        methods->map_row_major(quantized_pixels, compress_bitpack_apply, 
+                               &buffer);
         methods->free(&quantized_pixels);
+        free(buffer.bytes);
 }
 
 /*********************** compress_bitpack_apply *******************************
@@ -115,53 +99,91 @@ void compress_bitpack(A2Methods_UArray2 quantized_pixels)
  *                                        quantized values in quantized_values
  *                                        structs)
  *              void: *elem: The element at the index [col, row] in the UArray2
- *              void: *cl: Closure variable
+ *              void: *row_buffer: struct row_buffer holding the code words
+ *                                 of the row so far
  * Return:
- *              none - the 32 bit code word is printed to stdout using putchar
+ *              none - the code words of a row are printed to stdout after
+ *              its last one is stored
  * Expects:
- *              array2 and elem are not null
+ *              array2, elem and row_buffer are not null
  * Notes:
  *              will CRE if expectations fail
  *
  *****************************************************************************/
 void compress_bitpack_apply(int col, int row, A2Methods_UArray2 array2, 
-                            void *elem, void *cl)
+                            void *elem, void *row_buffer)
 {
         assert(array2 != NULL);
         assert(elem != NULL);
+        assert(row_buffer != NULL);
 
-        (void) col;
         (void) row;
-        (void) cl;
         
-        uint64_t word = (uint64_t)0;
+        struct row_buffer *buffer = row_buffer;
         quantized_values q = elem;
+        store_codeword(pack_fields(q), &buffer->bytes[col * CODEWORD_BYTES]);
 
-        /* Bitpack a */
-        word = Bitpack_newu(word, A_WIDTH, A_LSB, q->a);
-
-        /* Bitpack b */
-        word = Bitpack_news(word, B_WIDTH, B_LSB, q->b);
-
-        /* Bitpack c */
-        word = Bitpack_news(word, C_WIDTH, C_LSB, q->c);
-
-        /* Bitpack d */
-        word = Bitpack_news(word, D_WIDTH, D_LSB, q->d);
-
-        /* Bitpack pb */
-        word = Bitpack_newu(word, PB_WIDTH, PB_LSB, q->index_pb);
+        int width = uarray2_methods_plain->width(array2);
+        if (col == width - 1) {
+                fwrite(buffer->bytes, CODEWORD_BYTES, width, buffer->file);
+        }
+}
 
-        /* Bitpack pr */
-        word = Bitpack_newu(word, PR_WIDTH, PR_LSB, q->index_pr);
+/*************************** write_codeword_row *******************************
+ *
+ * Packs the quantized values of a row of blocks and writes their code words
+ * to an output stream with one fwrite
+ *
+ * Inputs:
+ *              quantized_values row: the quantized values of the blocks
+ *              unsigned blocks: the number of blocks in the row
+ *              unsigned char *buffer: room for blocks * CODEWORD_BYTES bytes
+ *              FILE *output: the stream to write the code words to
+ * Return:
+ *              none - the code words are written to output
+ * Expects:
+ *              row, buffer and output are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void write_codeword_row(quantized_values row, unsigned blocks, 
+                        unsigned char *buffer, FILE *output)
+{
+        assert(row != NULL && buffer != NULL && output != NULL);
 
-        /* Print the bitpacked codeword to stdout using putchar 
-           Codewords are written in big-endian order */
-        for(int i = 3; i >= 0; i--) {
-                uint64_t sub_word = Bitpack_getu(word, 8, i * 8);
-                putchar(sub_word);
+        for (unsigned i = 0; i < blocks; i++) {
+                store_codeword(pack_fields(&row[i]),
+                               &buffer[i * CODEWORD_BYTES]);
         }
+        fwrite(buffer, CODEWORD_BYTES, blocks, output);
+}
+
+/****************************** store_codeword ********************************
+ *
+ * Stores a 32 bit code word in memory in big-endian order, as it is written
+ * to a compressed file
+ *
+ * Inputs:
+ *              uint64_t word: the code word to store
+ *              unsigned char *bytes: where the four bytes are stored
+ * Return:
+ *              none - the code word is stored in bytes
+ * Expects:
+ *              bytes is not null
+ * Notes:
+ *              will CRE if expectations fail
+ *              htonl swaps the bytes with one instruction on little-endian
+ *                      machines
+ *
+ *****************************************************************************/
+void store_codeword(uint64_t word, unsigned char *bytes)
+{
+        assert(bytes != NULL);
 
+        /* Codewords are stored in big-endian order */
+        uint32_t big_endian = htonl((uint32_t)word);
+        memcpy(bytes, &big_endian, CODEWORD_BYTES);
 }
 
 /**************************** decompress_bitpack ******************************
@@ -190,11 +212,7 @@ A2Methods_UArray2 decompress_bitpack(FILE *input)
         
         /* Read in the header of the compressed file */
         unsigned height, width;
-        int read = fscanf(input, "COMP40 Compressed image format 2\n%u %u", 
-                          &width, &height);
-        assert(read == 2);
-        int c = getc(input);
-        assert(c == '\n');
+        read_compressed_header(input, &width, &height);
 
         /* Set the methods suite for the UArray2 */
         A2Methods_T methods = uarray2_methods_plain;
@@ -203,7 +221,11 @@ A2Methods_UArray2 decompress_bitpack(FILE *input)
         /* Initialize and traverse through a UArray2 to store codewords */
         A2Methods_UArray2 codewords = methods->new(width / 2, height / 2, 
                                                    sizeof(uint64_t));
-        methods->map_row_major(codewords, decompress_word_apply, input);
+        struct row_buffer buffer = {malloc(width / 2 * CODEWORD_BYTES + 1),
+                                    input};
+        assert(buffer.bytes != NULL);
+        methods->map_row_major(codewords, decompress_word_apply, &buffer);
+        free(buffer.bytes);
 
         /* Initialize a UArray2 to store quantized values */
         A2Methods_UArray2 quantized_pixs = methods->new(width / 2, height / 2, 
@@ -232,38 +254,36 @@ A2Methods_UArray2 decompress_bitpack(FILE *input)
  *              A2Methods_UArray2 array2: The UArray2 to traverse (stores
  *                                        codewords)
  *              void: *elem: The element at the index [col, row] in the UArray2
- *              void: *input: The input file to read from
+ *              void: *row_buffer: struct row_buffer with the input file to
+ *                                 read from and the bytes of the row
  * Return:
  *              none - the codewords are stored in array2
  * Expects:
- *              array2, elem, and input are not null
+ *              array2, elem, and row_buffer are not null
  * Notes:
  *              will CRE if expectations fail
+ *              the whole row is read when its first code word is needed
  *
  *****************************************************************************/
 void decompress_word_apply(int col, int row, A2Methods_UArray2 array2, 
-                            void *elem, void *input) 
+                            void *elem, void *row_buffer) 
 {
         assert(array2 != NULL);
         assert(elem != NULL);
-        assert(input != NULL);
+        assert(row_buffer != NULL);
         
-        (void) col;
         (void) row;
-        
-        FILE *fp = input;
-
-        /* Read in the codeword in big-endian order using getc */
-        uint64_t word = (uint64_t)0;
-        for(int i = 3; i >= 0; i--) {
-                int c = getc(fp);
-                assert(c != EOF);
-                word = Bitpack_newu(word, 8, i * 8, (uint64_t)c);
-        }
 
+        struct row_buffer *buffer = row_buffer;
+        if (col == 0) {
+                read_codeword_row(buffer->file, 
+                                  uarray2_methods_plain->width(array2),
+                                  buffer->bytes);
+        }
+        
         /* Store the codeword in the UArray2 */
         uint64_t *curr = elem;
-        *curr = word;
+        *curr = load_codeword(&buffer->bytes[col * CODEWORD_BYTES]);
 }
 
 /*********************** decompress_bitpack_apply *****************************
@@ -303,23 +323,96 @@ void decompress_bitpack_apply(int col, int row, A2Methods_UArray2 array2,
         /* Access to the codeword corresponding to the current pixel */
         uint64_t *word = methods->at(codewords, col, row);
         assert(word != NULL); 
-        quantized_values q = elem;
+        unpack_fields(*word, elem);
+}
 
-        /* Unpack a */
-        q->a = Bitpack_getu(*word, A_WIDTH, A_LSB);
+/************************** read_compressed_header ****************************
+ *
+ * Reads the header of a format 2 compressed file, up to its first code word
+ *
+ * Inputs:
+ *              FILE *input: pointer to input stream to read the header from
+ *              unsigned *width: where the width of the image is stored
+ *              unsigned *height: where the height of the image is stored
+ * Return:
+ *              none - the size of the image is stored in width and height
+ * Expects:
+ *              input, width, and height not to be null
+ *              the stream to start with a COMP40 format 2 header
+ * Notes:
+ *              will CRE if expectations fail
+ *              a format 3 file is reported on stderr and exits with 1, since
+ *                      only tiled_decompress40 reads it
+ *
+ *****************************************************************************/
+void read_compressed_header(FILE *input, unsigned *width, unsigned *height)
+{
+        assert(input != NULL);
+        assert(width != NULL && height != NULL);
+
+        unsigned format;
+        int read = fscanf(input, "COMP40 Compressed image format %u\n%u %u", 
+                          &format, width, height);
+        assert(read == 3);
+        if (format == 3) {
+                fprintf(stderr, "COMP40 format 3 is only read by 40image -d "
+                        "and 40image -d --region\n");
+                exit(1);
+        }
+        assert(format == 2);
+        int c = getc(input);
+        assert(c == '\n');
+}
 
-        /* Unpack b */
-        q->b = Bitpack_gets(*word, B_WIDTH, B_LSB);
+/****************************** load_codeword *********************************
+ *
+ * Gives the 32 bit code word stored in memory in big-endian order, as it is
+ * read from a compressed file
+ *
+ * Inputs:
+ *              const unsigned char *bytes: the four bytes of the code word
+ * Return:
+ *              the code word
+ * Expects:
+ *              bytes not to be null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+uint64_t load_codeword(const unsigned char *bytes)
+{
+        assert(bytes != NULL);
 
-        /* Unpack c */
-        q->c = Bitpack_gets(*word, C_WIDTH, C_LSB);
+        /* Codewords are stored in big-endian order */
+        uint32_t big_endian;
+        memcpy(&big_endian, bytes, CODEWORD_BYTES);
 
-        /* Unpack d */
-        q->d = Bitpack_gets(*word, D_WIDTH, D_LSB);
+        return ntohl(big_endian);
+}
 
-        /* Unpack pb */
-        q->index_pb = Bitpack_getu(*word, PB_WIDTH, PB_LSB);
+/**************************** read_codeword_row *******************************
+ *
+ * Reads the code words of a row of blocks from a stream with one fread
+ *
+ * Inputs:
+ *              FILE *input: pointer to input stream to read the code words
+ *                           from
+ *              unsigned blocks: the number of blocks in the row
+ *              unsigned char *buffer: room for blocks * CODEWORD_BYTES bytes
+ * Return:
+ *              none - the bytes are stored in buffer, and load_codeword 
+ *              gives each code word
+ * Expects:
+ *              input and buffer not to be null and the stream to hold the
+ *              whole row
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void read_codeword_row(FILE *input, unsigned blocks, unsigned char *buffer)
+{
+        assert(input != NULL && buffer != NULL);
 
-        /* Unpack pr */
-        q->index_pr = Bitpack_getu(*word, PR_WIDTH, PR_LSB);
-}
\ No newline at end of file
+        size_t read = fread(buffer, CODEWORD_BYTES, blocks, input);
+        assert(read == blocks);
+}
@@ -13,11 +13,95 @@
 
 /* Standard C Libraries */
 #include <stdio.h>
+#include <stdint.h>
 
 /* CS40 Libraries */
 #include <a2methods.h>
 
+/* Custom .h files */
+#include "compress_structs.h"
+#include "bitpack_inline.h"
+
+/* Bytes of a code word in a compressed file */
+#define CODEWORD_BYTES 4
+
+/* Width (in bits) and lowest significant bit of each subword in a code word */
+#define A_WIDTH 9
+#define A_LSB 23
+#define B_WIDTH 5
+#define B_LSB 18
+#define C_WIDTH 5
+#define C_LSB 13
+#define D_WIDTH 5
+#define D_LSB 8
+#define PB_WIDTH 4
+#define PB_LSB 4
+#define PR_WIDTH 4
+#define PR_LSB 0
+
 extern void compress_bitpack(A2Methods_UArray2 quantized_pixels);
 extern A2Methods_UArray2 decompress_bitpack(FILE *input);
+extern void store_codeword(uint64_t word, unsigned char *bytes);
+extern void write_codeword_row(quantized_values row, unsigned blocks, 
+                               unsigned char *buffer, FILE *output);
+extern void read_compressed_header(FILE *input, unsigned *width, 
+                                   unsigned *height);
+extern uint64_t load_codeword(const unsigned char *bytes);
+extern void read_codeword_row(FILE *input, unsigned blocks, 
+                              unsigned char *buffer);
+
+/******************************* pack_fields **********************************
+ *
+ * Bitpacks the six quantized values of one 2x2 block into a 32 bit code word
+ * without checking that they fit
+ *
+ * Inputs:
+ *              quantized_values q: the quantized values to pack
+ * Return:
+ *              the code word holding q in its 32 least significant bits
+ * Expects:
+ *              q is not null and each value fits in its subword, as the
+ *              quantized values of merge_blocks.c and block_rows.c do
+ * Notes:
+ *              expectations are not checked
+ *
+ *****************************************************************************/
+static inline uint64_t pack_fields(quantized_values q)
+{
+        uint64_t word = 0;
+        word = Bitpack_inline_newu(word, A_WIDTH, A_LSB, q->a);
+        word = Bitpack_inline_news(word, B_WIDTH, B_LSB, q->b);
+        word = Bitpack_inline_news(word, C_WIDTH, C_LSB, q->c);
+        word = Bitpack_inline_news(word, D_WIDTH, D_LSB, q->d);
+        word = Bitpack_inline_newu(word, PB_WIDTH, PB_LSB, q->index_pb);
+        word = Bitpack_inline_newu(word, PR_WIDTH, PR_LSB, q->index_pr);
+
+        return word;
+}
+
+/****************************** unpack_fields *********************************
+ *
+ * Unpacks the six quantized values of one 2x2 block from a 32 bit code word
+ *
+ * Inputs:
+ *              uint64_t word: the code word to unpack
+ *              quantized_values q: where the quantized values are stored
+ * Return:
+ *              none - the quantized values are stored in q
+ * Expects:
+ *              q is not null
+ * Notes:
+ *              expectations are not checked
+ *
+ *****************************************************************************/
+static inline void unpack_fields(uint64_t word, quantized_values q)
+{
+        q->a = Bitpack_inline_getu(word, A_WIDTH, A_LSB);
+        q->b = Bitpack_inline_gets(word, B_WIDTH, B_LSB);
+        q->c = Bitpack_inline_gets(word, C_WIDTH, C_LSB);
+        q->d = Bitpack_inline_gets(word, D_WIDTH, D_LSB);
+        q->index_pb = Bitpack_inline_getu(word, PB_WIDTH, PB_LSB);
+        q->index_pr = Bitpack_inline_getu(word, PR_WIDTH, PR_LSB);
+}
 
 #endif
\ No newline at end of file
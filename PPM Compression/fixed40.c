@@ -0,0 +1,424 @@
+/*
+ *      fixed40.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Implementation for the fixed40.h file. Every value between the rgb
+ *      integers and the code words is an integer in units of 1 / FIXED_ONE:
+ *      an rgb value of 1 (the denominator) is FIXED_ONE, and so is a Y of 1.
+ *      Each sample is turned into these units with a table built once per
+ *      image, the Y, Pb and Pr weights are rounded to the same units, and
+ *      the scaling to a, b, c and d and back only needs multiplies, shifts
+ *      and divisions by constants. Chroma indices come from the fixed point
+ *      tables of chroma.c. The results differ from the float steps only
+ *      where rounding to 1 / 65536 crosses a quantization step
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/* CS40 Libraries */
+#include <pnm.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "fixed40.h"
+#include "compress_structs.h"
+#include "read_and_write.h"
+#include "final_bitpack.h"
+#include "chroma.h"
+
+/* The fixed point value of 1, and its number of bits */
+#define FIXED_BITS 16
+#define FIXED_ONE (1 << FIXED_BITS)
+
+/* The weights of rgb in Y, Pb and Pr, times FIXED_ONE and rounded; each
+   set adds up to FIXED_ONE for Y and to 0 for Pb and Pr, as the float
+   weights do */
+static const int64_t Y_R = 19595, Y_G = 38470, Y_B = 7471;
+static const int64_t PB_R = -11058, PB_G = -21710, PB_B = 32768;
+static const int64_t PR_R = 32768, PR_G = -27439, PR_B = -5329;
+
+/* The weights of Pb and Pr in rgb, times FIXED_ONE and rounded */
+static const int64_t R_PR = 91881;
+static const int64_t G_PB = -22553, G_PR = -46802;
+static const int64_t B_PB = 116130;
+
+/* Scale factors of a and of b, c, d, and the largest b, c, d (0.3 * 50) */
+static const int A_SCALE_FACTOR = 511;
+static const int B_C_D_SCALE_FACTOR = 50;
+static const int B_C_D_MAX = 15;
+
+/* The denominator of decompressed images */
+static const unsigned RGB_DENOMINATOR = 255;
+
+void fixed_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                     const int32_t *unit, quantized_values row);
+void fixed_pixel(struct Pnm_rgb pixel, const int32_t *unit, int32_t *y,
+                 int32_t *pb, int32_t *pr);
+int fixed_bcd(int32_t sum);
+void fixed_decompress_block(uint64_t word, Pnm_rgb top, Pnm_rgb bottom);
+int32_t fixed_unscale_bcd(int value);
+int32_t clamp_fixed(int32_t value, int32_t min, int32_t max);
+unsigned fixed_to_rgb(int32_t value);
+
+
+/***************************** fixed_compress40 *******************************
+ *
+ * Compresses a ppm image with fixed point math and writes output to stdout,
+ * one row of 2x2 blocks at a time
+ *
+ * Inputs:
+ *              FILE *input: The ppm image to compress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL
+ *              every rgb value to be at most the denominator
+ * Notes:
+ *              will CRE if expectations fail
+ *              only two scanlines of the image are held in memory
+ *              an odd last column or row is trimmed, as compress40 does
+ *
+ *****************************************************************************/
+void fixed_compress40(FILE *input)
+{
+        assert(input != NULL);
+
+        ppm_header header = read_ppm_header(input);
+
+        /* If width or height is odd, trim the last column or row */
+        unsigned width = header.width - header.width % 2;
+        unsigned height = header.height - header.height % 2;
+
+        /* unit[v] is the rgb value v over the denominator, in fixed point */
+        int32_t *unit = malloc((header.denominator + 1) * sizeof(int32_t));
+        assert(unit != NULL);
+        for (unsigned v = 0; v <= header.denominator; v++) {
+                unit[v] = ((int64_t)v * FIXED_ONE + header.denominator / 2) /
+                          header.denominator;
+        }
+
+        /* The two scanlines, read as raw samples with one call, and the
+           quantized values of a row of blocks */
+        size_t sample_bytes = ppm_sample_bytes(header);
+        unsigned char *samples = malloc(2 * sample_bytes + 1);
+        Pnm_rgb top = malloc(header.width * sizeof(struct Pnm_rgb) + 1);
+        Pnm_rgb bottom = malloc(header.width * sizeof(struct Pnm_rgb) + 1);
+        unsigned blocks = width / 2;
+        quantized_values quantized = malloc((blocks + 1) *
+                                            sizeof(struct quantized_values));
+        unsigned char *codewords = malloc(blocks * CODEWORD_BYTES + 1);
+        assert(samples != NULL && top != NULL && bottom != NULL &&
+               quantized != NULL && codewords != NULL);
+
+        /* Print output header */
+        printf("COMP40 Compressed image format 2\n%u %u\n", width, height);
+
+        for (unsigned row = 0; row < height; row += 2) {
+                read_ppm_samples(input, header, 2, samples);
+                samples_to_ppm_row(samples, header, top);
+                samples_to_ppm_row(samples + sample_bytes, header, bottom);
+
+                /* Make sure every sample has an entry in unit */
+                unsigned d = header.denominator;
+                int over = 0;
+                for (unsigned col = 0; col < width; col++) {
+                        over |= (top[col].red > d) | (top[col].green > d) |
+                                (top[col].blue > d) | (bottom[col].red > d) |
+                                (bottom[col].green > d) |
+                                (bottom[col].blue > d);
+                }
+                assert(!over);
+
+                fixed_block_row(top, bottom, blocks, unit, quantized);
+                write_codeword_row(quantized, blocks, codewords, stdout);
+        }
+
+        free(unit);
+        free(samples);
+        free(top);
+        free(bottom);
+        free(quantized);
+        free(codewords);
+}
+
+/***************************** fixed_block_row ********************************
+ *
+ * fixed_compress40 helper function - quantizes the 2x2 blocks of two
+ * scanlines
+ *
+ * Inputs:
+ *              Pnm_rgb top: the upper scanline of the blocks
+ *              Pnm_rgb bottom: the lower scanline of the blocks
+ *              unsigned blocks: the number of blocks
+ *              const int32_t *unit: the fixed point value of each rgb value
+ *              quantized_values row: where the values of each block are
+ *                                    stored
+ * Return:
+ *              none - the quantized values are stored in row
+ * Expects:
+ *              every rgb value to have an entry in unit
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+void fixed_block_row(Pnm_rgb top, Pnm_rgb bottom, unsigned blocks,
+                     const int32_t *unit, quantized_values row)
+{
+        for (unsigned i = 0; i < blocks; i++) {
+                int32_t y1, y2, y3, y4, pb1, pb2, pb3, pb4, pr1, pr2, pr3, pr4;
+                fixed_pixel(top[2 * i], unit, &y1, &pb1, &pr1);
+                fixed_pixel(top[2 * i + 1], unit, &y2, &pb2, &pr2);
+                fixed_pixel(bottom[2 * i], unit, &y3, &pb3, &pr3);
+                fixed_pixel(bottom[2 * i + 1], unit, &y4, &pb4, &pr4);
+
+                /* a is the average Y times 511, rounded down as a cast does;
+                   the sum of four Ys has two more bits than one */
+                row[i].a = (A_SCALE_FACTOR * (y1 + y2 + y3 + y4)) >>
+                           (FIXED_BITS + 2);
+                row[i].b = fixed_bcd(y4 + y3 - y2 - y1);
+                row[i].c = fixed_bcd(y4 - y3 + y2 - y1);
+                row[i].d = fixed_bcd(y4 - y3 - y2 + y1);
+
+                /* The averages are rounded down to whole units */
+                row[i].index_pb = index_of_fixed_chroma((pb1 + pb2 + pb3 +
+                                                         pb4) >> 2);
+                row[i].index_pr = index_of_fixed_chroma((pr1 + pr2 + pr3 +
+                                                         pr4) >> 2);
+        }
+}
+
+/******************************* fixed_pixel **********************************
+ *
+ * fixed_block_row helper function - converts one pixel to fixed point Y,
+ * Pb and Pr
+ *
+ * Inputs:
+ *              struct Pnm_rgb pixel: the pixel
+ *              const int32_t *unit: the fixed point value of each rgb value
+ *              int32_t *y, *pb, *pr: where Y, Pb and Pr are stored
+ * Return:
+ *              none - Y is stored in 0 to FIXED_ONE, and Pb and Pr in
+ *              -FIXED_ONE / 2 to FIXED_ONE / 2
+ * Expects:
+ *              every rgb value of pixel to have an entry in unit
+ * Notes:
+ *              each value is rounded down to a whole unit
+ *
+ *****************************************************************************/
+void fixed_pixel(struct Pnm_rgb pixel, const int32_t *unit, int32_t *y,
+                 int32_t *pb, int32_t *pr)
+{
+        int64_t r = unit[pixel.red];
+        int64_t g = unit[pixel.green];
+        int64_t b = unit[pixel.blue];
+
+        *y = (Y_R * r + Y_G * g + Y_B * b) >> FIXED_BITS;
+        *pb = (PB_R * r + PB_G * g + PB_B * b) >> FIXED_BITS;
+        *pr = (PR_R * r + PR_G * g + PR_B * b) >> FIXED_BITS;
+}
+
+/******************************** fixed_bcd ***********************************
+ *
+ * fixed_block_row helper function - scales a sum of four fixed point Ys,
+ * added or subtracted as b, c or d needs them, to the quantized value
+ *
+ * Inputs:
+ *              int32_t sum: the sum, four times the float b, c or d
+ * Return:
+ *              the sum over 4 truncated to -0.3 to 0.3 and times 50,
+ *              rounded toward zero as a cast does
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+int fixed_bcd(int32_t sum)
+{
+        int value = (B_C_D_SCALE_FACTOR * sum) / (4 * FIXED_ONE);
+
+        return clamp_fixed(value, -B_C_D_MAX, B_C_D_MAX);
+}
+
+/**************************** fixed_decompress40 ******************************
+ *
+ * Decompresses a compressed file back to ppm file format with fixed point
+ * math, one row of code words at a time
+ *
+ * Inputs:
+ *              FILE *input: The file to decompress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL
+ * Notes:
+ *              will CRE if expectations fail
+ *              only two scanlines of the image are held in memory
+ *              rgb values are truncated to 0 to 1 and scaled by 255, as
+ *                      stream_decompress40 does
+ *
+ *****************************************************************************/
+void fixed_decompress40(FILE *input)
+{
+        assert(input != NULL);
+
+        unsigned width, height;
+        read_compressed_header(input, &width, &height);
+
+        /* The two scanlines of the current row of blocks */
+        Pnm_rgb top = malloc(width * sizeof(struct Pnm_rgb) + 1);
+        Pnm_rgb bottom = malloc(width * sizeof(struct Pnm_rgb) + 1);
+        unsigned char *codewords = malloc(width / 2 * CODEWORD_BYTES + 1);
+        assert(top != NULL && bottom != NULL && codewords != NULL);
+
+        write_ppm_header(width, height, RGB_DENOMINATOR);
+
+        for (unsigned row = 0; row < height; row += 2) {
+                read_codeword_row(input, width / 2, codewords);
+                for (unsigned col = 0; col < width; col += 2) {
+                        uint64_t word = load_codeword(&codewords[col / 2 *
+                                                      CODEWORD_BYTES]);
+                        fixed_decompress_block(word, &top[col], &bottom[col]);
+                }
+                write_ppm_row(top, width);
+                write_ppm_row(bottom, width);
+        }
+
+        free(top);
+        free(bottom);
+        free(codewords);
+}
+
+/************************** fixed_decompress_block ****************************
+ *
+ * fixed_decompress40 helper function - unpacks one code word and stores the
+ * scaled rgb values of its 2x2 block
+ *
+ * Inputs:
+ *              uint64_t word: the code word of the block
+ *              Pnm_rgb top: where the top left pixel of the block is stored,
+ *                           followed by the top right pixel
+ *              Pnm_rgb bottom: where the bottom left pixel of the block is
+ *                              stored, followed by the bottom right pixel
+ * Return:
+ *              none - the pixels are stored in top and bottom
+ * Expects:
+ *              top and bottom are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void fixed_decompress_block(uint64_t word, Pnm_rgb top, Pnm_rgb bottom)
+{
+        assert(top != NULL && bottom != NULL);
+
+        struct quantized_values q;
+        unpack_fields(word, &q);
+
+        /* a over 511 and b, c, d over 50 in fixed point, rounded */
+        int32_t a = ((int32_t)q.a * FIXED_ONE + A_SCALE_FACTOR / 2) /
+                    A_SCALE_FACTOR;
+        int32_t b = fixed_unscale_bcd(q.b);
+        int32_t c = fixed_unscale_bcd(q.c);
+        int32_t d = fixed_unscale_bcd(q.d);
+        int32_t y[4] = {
+                clamp_fixed(a - b - c + d, 0, FIXED_ONE),
+                clamp_fixed(a - b + c - d, 0, FIXED_ONE),
+                clamp_fixed(a + b - c - d, 0, FIXED_ONE),
+                clamp_fixed(a + b + c + d, 0, FIXED_ONE)
+        };
+
+        /* Pb and Pr are the same for all four pixels */
+        int64_t pb = fixed_chroma_of_index(q.index_pb);
+        int64_t pr = fixed_chroma_of_index(q.index_pr);
+        int32_t red = (R_PR * pr) >> FIXED_BITS;
+        int32_t green = (G_PB * pb + G_PR * pr) >> FIXED_BITS;
+        int32_t blue = (B_PB * pb) >> FIXED_BITS;
+
+        Pnm_rgb pixels[4] = {&top[0], &top[1], &bottom[0], &bottom[1]};
+        for (int i = 0; i < 4; i++) {
+                pixels[i]->red = fixed_to_rgb(y[i] + red);
+                pixels[i]->green = fixed_to_rgb(y[i] + green);
+                pixels[i]->blue = fixed_to_rgb(y[i] + blue);
+        }
+}
+
+/**************************** fixed_unscale_bcd *******************************
+ *
+ * fixed_decompress_block helper function - gives a quantized b, c or d
+ * over 50 in fixed point
+ *
+ * Inputs:
+ *              int value: the quantized value
+ * Return:
+ *              value / 50 in fixed point, rounded to the nearest unit
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+int32_t fixed_unscale_bcd(int value)
+{
+        int32_t half = value < 0 ? -B_C_D_SCALE_FACTOR / 2
+                                 : B_C_D_SCALE_FACTOR / 2;
+
+        return (value * FIXED_ONE + half) / B_C_D_SCALE_FACTOR;
+}
+
+/******************************* clamp_fixed **********************************
+ *
+ * Truncates a fixed point value to a range
+ *
+ * Inputs:
+ *              int32_t value: the value
+ *              int32_t min, max: the range
+ * Return:
+ *              min if value is below min, max if value is above max, value
+ *              otherwise
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+int32_t clamp_fixed(int32_t value, int32_t min, int32_t max)
+{
+        if (value < min) {
+                return min;
+        }
+        if (value > max) {
+                return max;
+        }
+
+        return value;
+}
+
+/******************************* fixed_to_rgb *********************************
+ *
+ * fixed_decompress_block helper function - scales a fixed point rgb value
+ * to 0 to 255
+ *
+ * Inputs:
+ *              int32_t value: the rgb value in fixed point
+ * Return:
+ *              the value truncated to 0 to 1 and times 255, rounded down as
+ *              float_to_rgb's cast does
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+unsigned fixed_to_rgb(int32_t value)
+{
+        value = clamp_fixed(value, 0, FIXED_ONE);
+
+        return ((unsigned)value * RGB_DENOMINATOR) >> FIXED_BITS;
+}
@@ -0,0 +1,20 @@
+/*
+ *      fixed40.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Interface for the fixed40.c file. Functions in this file compress a
+ *      ppm image and decompress a compressed file one row of 2x2 blocks at a
+ *      time, like stream40.c, with integer fixed point math instead of floats
+ */
+
+#ifndef FIXED40_INCLUDED
+#define FIXED40_INCLUDED
+
+/* Standard C Libraries */
+#include <stdio.h>
+
+extern void fixed_compress40(FILE *input);
+extern void fixed_decompress40(FILE *input);
+
+#endif
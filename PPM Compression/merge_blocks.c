@@ -14,7 +14,6 @@
 #include <math.h>
 
 /* CS40 Libraries */
-#include <arith40.h>
 #include <a2blocked.h>
 #include <a2plain.h>
 
@@ -24,10 +23,9 @@
 /* Custom .h Files */
 #include "compress_structs.h"
 #include "merge_blocks.h"
+#include "chroma.h"
 
 
-void compress_merge_apply(int col, int row, A2Methods_UArray2 array2b,  
-                          void *elem, void *params);
 void decompress_merge_apply(int col, int row, A2Methods_UArray2 array2,  
                           void *elem, void *params);
 
@@ -81,132 +79,170 @@ static const float B_C_D_SCALE_FACTOR = 50.0;
  * Compresses 2x2 blocks of component video pixels into 1x1 quantized blocks
  *
  * Inputs:
- *              A2Methods_UArray2 component_pixels: UArray2 of pixels that are
- *                                                  in component video form
+ *              planar_image component: planar image holding Y, Pb and Pr
+ *                                      planes
  * Return:
  *              A2Methods_UArray2 storing quantized values
  * Expects:
- *              A2Methods_UArray2 component_pixels not to be null
+ *              planar_image component not to be null
  * Notes:
  *              will CRE if expectations fail
- *              the user accepts that  A2Methods_UArray2 component_pixels is 
- *                      freed
+ *              the user accepts that planar_image component is freed
  *              it is the resposibility of the user to free the 
  *                      returned quantized_pixels array
  *
  *****************************************************************************/
-A2Methods_UArray2 compress_merge(A2Methods_UArray2 component_pixels) 
+A2Methods_UArray2 compress_merge(planar_image component) 
 {
-        assert(component_pixels != NULL);    
+        assert(component != NULL);    
     
-        /* Set up blocked and plain methods */
-        A2Methods_T methodsB = uarray2_methods_blocked;
-        assert(methodsB);
+        /* Set up plain methods */
         A2Methods_T methodsP = uarray2_methods_plain;
         assert(methodsP);
         
         /* Initialize the new quantized_pixels UArray2 */
-        int width = methodsB->width(component_pixels) / 2;
-        int height = methodsB->height(component_pixels) / 2;
+        int width = component->width / 2;
+        int height = component->height / 2;
         A2Methods_UArray2 quantized_pixels = methodsP->new(width, height,
                                               sizeof(struct quantized_values));
         
-        /* Traverse component video pixels and store them as quantized values
-           in new array */
-        struct compress_parameters params = {quantized_pixels, methodsB, 
-                                             methodsP};
-        methodsB->map_block_major(component_pixels, compress_merge_apply, 
-                                  &params);
+        /* Traverse blocks and store them as quantized values in new array */
+        for (int row = 0; row < height; row++) {
+                for (int col = 0; col < width; col++) {
+                        merge_planar_block(component, col * 2, row * 2,
+                                   methodsP->at(quantized_pixels, col, row));
+                }
+        }
 
         /* Free component pixels */
-        methodsB->free(&component_pixels);
+        planar_free(&component);
                                     
         return quantized_pixels;
 
 }
 
-
-/*********************** compress_merge_apply *********************************
+/****************************** merge_block_row *******************************
  *
- * compress_merge helper function - used when mapping through the 2D
- * UArray of pixels to merge Y, Pb, Pr floats in 2-by-2 blocks to a, b, c, d,
- * index_pb, and index_pr variables.
+ * Compresses a row of 2x2 blocks of a planar image to quantized values
  *
  * Inputs:
- *              int col: The current column in the UArray2
- *              int row: The current row in the UArray2
- *              A2Methods_UArray2 array2b: The UArray2 to traverse (contains
- *                                         float Y, Pb, Pr values in
- *                                         component_video structs)
- *              void: *elem: The element at the index [col, row] in the UArray2
- *              void: *params: Struct containing the UArray2 that we are 
- *                             mapping into (contains a, b, c, d, index_pb, and
- *                             index_pr variables in quantized_values structs) 
- *                             and its associated method suites
+ *              planar_image component: planar image holding Y, Pb and Pr
+ *                                      planes
+ *              int row: the top row of the blocks
+ *              quantized_values blocks: array of component->width / 2 
+ *                                       quantized values to fill in
  * Return:
- *              none - the UArray2s that we update are passed by reference
+ *              none - the quantized values are stored in blocks
  * Expects:
- *              array2b, elem, and params are not null
+ *              component and blocks not to be null, and row and row + 1 to be
+ *              rows of component
  * Notes:
  *              will CRE if expectations fail
  *
  *****************************************************************************/
-void compress_merge_apply(int col, int row, A2Methods_UArray2 array2b,  
-                          void *elem, void *params)
-{ 
-        assert(array2b != NULL);
-        assert(elem != NULL);
-        assert(params != NULL);
+void merge_block_row(planar_image component, int row, quantized_values blocks)
+{
+        assert(component != NULL);
+        assert(blocks != NULL);
 
-        /* Check if the current elem is the top left pixel in a block */
-        if (col % 2 == 0 && row % 2 == 0) {
-                /* Load in compress_prm information */
-                struct compress_parameters *compress_prm = params;
-                A2Methods_UArray2 quant_pix = compress_prm->pixels;
-                A2Methods_T methodsB = compress_prm->methodsB;
-                A2Methods_T methodsP = compress_prm->methodsP;
-
-                /* Access to other pixels in the same block as the current */
-                component_video c1 = elem;
-                struct component_video *c2 = methodsB->at(array2b, col + 1, 
-                                                          row);
-                struct component_video *c3 = methodsB->at(array2b, col, 
-                                                          row + 1);
-                struct component_video *c4 = methodsB->at(array2b, col + 1, 
-                                                          row + 1);
-
-                /* Access to the quantized pixel corresponding to the block */
-                struct quantized_values *new_pixel = methodsP->at(quant_pix, 
-                                                             col / 2, row / 2);
-                
-                /* Make sure y values are in the correct range */
-                c1->y = truncate(c1->y, Y_MIN, Y_MAX);
-                c2->y = truncate(c2->y, Y_MIN, Y_MAX);
-                c3->y = truncate(c3->y, Y_MIN, Y_MAX);
-                c4->y = truncate(c4->y, Y_MIN, Y_MAX);
-
-                /* Make sure pb values are in the correct range */
-                c1->pb = truncate(c1->pb, -PB_PR_RANGE, PB_PR_RANGE);
-                c2->pb = truncate(c2->pb, -PB_PR_RANGE, PB_PR_RANGE);
-                c3->pb = truncate(c3->pb, -PB_PR_RANGE, PB_PR_RANGE);
-                c4->pb = truncate(c4->pb, -PB_PR_RANGE, PB_PR_RANGE);
-
-                /* Make sure pr values are in the correct range */
-                c1->pr = truncate(c1->pr, -PB_PR_RANGE, PB_PR_RANGE);
-                c2->pr = truncate(c2->pr, -PB_PR_RANGE, PB_PR_RANGE);
-                c3->pr = truncate(c3->pr, -PB_PR_RANGE, PB_PR_RANGE);
-                c4->pr = truncate(c4->pr, -PB_PR_RANGE, PB_PR_RANGE);
-
-                /* Calculate quantized values from y, pb, pr floats */
-                new_pixel->a = calc_a(c1->y, c2->y, c3->y, c4->y);
-                new_pixel->b = calc_b(c1->y, c2->y, c3->y, c4->y);
-                new_pixel->c = calc_c(c1->y, c2->y, c3->y, c4->y);
-                new_pixel->d = calc_d(c1->y, c2->y, c3->y, c4->y);
-                new_pixel->index_pb = calc_index_pb(c1->pb, c2->pb, c3->pb, 
-                                                    c4->pb);
-                new_pixel->index_pr = calc_index_pr(c1->pr, c2->pr, c3->pr, 
-                                                    c4->pr);
+        for (int col = 0; col + 1 < component->width; col += 2) {
+                merge_planar_block(component, col, row, &blocks[col / 2]);
+        }
+}
+
+/**************************** merge_planar_block ******************************
+ *
+ * Compresses the 2x2 block of a planar image whose top left pixel is at 
+ * [col, row] to quantized values
+ *
+ * Inputs:
+ *              planar_image component: planar image holding Y, Pb and Pr
+ *                                      planes
+ *              int col: the left column of the block
+ *              int row: the top row of the block
+ *              quantized_values q: where the quantized values are stored
+ * Return:
+ *              none - the quantized values are stored in q
+ * Expects:
+ *              component and q not to be null and the block to be in the
+ *              image
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void merge_planar_block(planar_image component, int col, int row, 
+                        quantized_values q)
+{
+        assert(component != NULL);
+        assert(q != NULL);
+
+        /* Gather the four pixels of the block, in the order merge_block
+           takes them */
+        struct component_video c[4];
+        for (int i = 0; i < 4; i++) {
+                int pixel_row = row + i / 2;
+                int pixel_col = col + i % 2;
+                c[i].y = planar_row(component, PLANE_Y, pixel_row)[pixel_col];
+                c[i].pb = planar_row(component, PLANE_PB, 
+                                     pixel_row)[pixel_col];
+                c[i].pr = planar_row(component, PLANE_PR, 
+                                     pixel_row)[pixel_col];
         }
+
+        merge_block(&c[0], &c[1], &c[2], &c[3], q);
+}
+
+/******************************* merge_block **********************************
+ *
+ * Merges the component video values of one 2x2 block into its quantized 
+ * values
+ *
+ * Inputs:
+ *              component_video c1: top left pixel in the block
+ *              component_video c2: top right pixel in the block
+ *              component_video c3: bottom left pixel in the block
+ *              component_video c4: bottom right pixel in the block
+ *              quantized_values q: where the quantized values are stored
+ * Return:
+ *              none - the quantized values are stored in q
+ * Expects:
+ *              c1, c2, c3, c4 and q are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *              the Y, Pb, Pr values of c1 to c4 are truncated in place
+ *
+ *****************************************************************************/
+void merge_block(component_video c1, component_video c2, component_video c3,
+                 component_video c4, quantized_values q)
+{
+        assert(c1 != NULL && c2 != NULL && c3 != NULL && c4 != NULL);
+        assert(q != NULL);
+
+        /* Make sure y values are in the correct range */
+        c1->y = truncate(c1->y, Y_MIN, Y_MAX);
+        c2->y = truncate(c2->y, Y_MIN, Y_MAX);
+        c3->y = truncate(c3->y, Y_MIN, Y_MAX);
+        c4->y = truncate(c4->y, Y_MIN, Y_MAX);
+
+        /* Make sure pb values are in the correct range */
+        c1->pb = truncate(c1->pb, -PB_PR_RANGE, PB_PR_RANGE);
+        c2->pb = truncate(c2->pb, -PB_PR_RANGE, PB_PR_RANGE);
+        c3->pb = truncate(c3->pb, -PB_PR_RANGE, PB_PR_RANGE);
+        c4->pb = truncate(c4->pb, -PB_PR_RANGE, PB_PR_RANGE);
+
+        /* Make sure pr values are in the correct range */
+        c1->pr = truncate(c1->pr, -PB_PR_RANGE, PB_PR_RANGE);
+        c2->pr = truncate(c2->pr, -PB_PR_RANGE, PB_PR_RANGE);
+        c3->pr = truncate(c3->pr, -PB_PR_RANGE, PB_PR_RANGE);
+        c4->pr = truncate(c4->pr, -PB_PR_RANGE, PB_PR_RANGE);
+
+        /* Calculate quantized values from y, pb, pr floats */
+        q->a = calc_a(c1->y, c2->y, c3->y, c4->y);
+        q->b = calc_b(c1->y, c2->y, c3->y, c4->y);
+        q->c = calc_c(c1->y, c2->y, c3->y, c4->y);
+        q->d = calc_d(c1->y, c2->y, c3->y, c4->y);
+        q->index_pb = calc_index_pb(c1->pb, c2->pb, c3->pb, c4->pb);
+        q->index_pr = calc_index_pr(c1->pr, c2->pr, c3->pr, c4->pr);
 }
 
 /*********************************** calc_a **********************************
@@ -347,7 +383,7 @@ unsigned calc_index_pb(float pb1, float pb2, float pb3, float pb4)
         assert(pb3 >= -PB_PR_RANGE && pb3 <= PB_PR_RANGE);
         assert(pb4 >= -PB_PR_RANGE && pb4 <= PB_PR_RANGE);
         float pb_avg = (pb1 + pb2 + pb3 + pb4) / 4.0;
-        return Arith40_index_of_chroma(pb_avg);
+        return index_of_chroma(pb_avg);
 }
 
 /******************************* calc_index_pr ********************************
@@ -376,7 +412,7 @@ unsigned calc_index_pr(float pr1, float pr2, float pr3, float pr4)
         assert(pr3 >= -PB_PR_RANGE && pr3 <= PB_PR_RANGE);
         assert(pr4 >= -PB_PR_RANGE && pr4 <= PB_PR_RANGE);
         float pr_avg = (pr1 + pr2 + pr3 + pr4) / 4.0;
-        return Arith40_index_of_chroma(pr_avg);
+        return index_of_chroma(pr_avg);
 }
 
 /************************** decompress_merge_blocks ***************************
@@ -479,11 +515,39 @@ void decompress_merge_apply(int col, int row, A2Methods_UArray2 array2,
         struct component_video *c4 = methodsB->at(comp_pixels, comp_col + 1, 
                                                   comp_row + 1);
 
+        split_block(q1, c1, c2, c3, c4);
+}
+
+/******************************* split_block **********************************
+ *
+ * Splits the quantized values of one 2x2 block into the component video 
+ * values of its four pixels
+ *
+ * Inputs:
+ *              quantized_values q: the quantized values of the block
+ *              component_video c1: where the top left pixel is stored
+ *              component_video c2: where the top right pixel is stored
+ *              component_video c3: where the bottom left pixel is stored
+ *              component_video c4: where the bottom right pixel is stored
+ * Return:
+ *              none - the component video values are stored in c1 to c4
+ * Expects:
+ *              q, c1, c2, c3 and c4 are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void split_block(quantized_values q, component_video c1, component_video c2,
+                 component_video c3, component_video c4)
+{
+        assert(q != NULL);
+        assert(c1 != NULL && c2 != NULL && c3 != NULL && c4 != NULL);
+
         /* Unscale the a, b, c, d float values*/
-        float a_float = ((float) q1->a) / A_SCALE_FACTOR;
-        float b_float = ((float) q1->b) / B_C_D_SCALE_FACTOR;
-        float c_float = ((float) q1->c) / B_C_D_SCALE_FACTOR;
-        float d_float = ((float) q1->d) / B_C_D_SCALE_FACTOR;
+        float a_float = ((float) q->a) / A_SCALE_FACTOR;
+        float b_float = ((float) q->b) / B_C_D_SCALE_FACTOR;
+        float c_float = ((float) q->c) / B_C_D_SCALE_FACTOR;
+        float d_float = ((float) q->d) / B_C_D_SCALE_FACTOR;
         
         /* Calculate the y values */
         c1->y = calc_y1(a_float, b_float, c_float, d_float);
@@ -491,25 +555,17 @@ void decompress_merge_apply(int col, int row, A2Methods_UArray2 array2,
         c3->y = calc_y3(a_float, b_float, c_float, d_float);
         c4->y = calc_y4(a_float, b_float, c_float, d_float);
 
-        /* Calculate the pb values */
-        c1->pb = truncate(Arith40_chroma_of_index(q1->index_pb), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
-        c2->pb = truncate(Arith40_chroma_of_index(q1->index_pb), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
-        c3->pb = truncate(Arith40_chroma_of_index(q1->index_pb), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
-        c4->pb = truncate(Arith40_chroma_of_index(q1->index_pb), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
-
-        /* Calculate the pr values */
-        c1->pr = truncate(Arith40_chroma_of_index(q1->index_pr), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
-        c2->pr = truncate(Arith40_chroma_of_index(q1->index_pr), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
-        c3->pr = truncate(Arith40_chroma_of_index(q1->index_pr), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
-        c4->pr = truncate(Arith40_chroma_of_index(q1->index_pr), 
-                        -PB_PR_RANGE, PB_PR_RANGE);
+        /* Look up the pb and pr values, truncated to -0.5 to 0.5 */
+        float pb = chroma_of_index(q->index_pb);
+        float pr = chroma_of_index(q->index_pr);
+        c1->pb = pb;
+        c2->pb = pb;
+        c3->pb = pb;
+        c4->pb = pb;
+        c1->pr = pr;
+        c2->pr = pr;
+        c3->pr = pr;
+        c4->pr = pr;
 }
 
 /******************************* calc_y1 ********************************
@@ -14,7 +14,21 @@
 /* CS40 Libraries */
 #include <a2methods.h>
 
-extern A2Methods_UArray2 compress_merge(A2Methods_UArray2 component_pixels);
+/* Custom .h files */
+#include "compress_structs.h"
+#include "planar.h"
+
+extern A2Methods_UArray2 compress_merge(planar_image component);
+extern void merge_block_row(planar_image component, int row, 
+                            quantized_values blocks);
+extern void merge_planar_block(planar_image component, int col, int row, 
+                               quantized_values q);
 extern A2Methods_UArray2 decompress_merge_blocks(A2Methods_UArray2 quant_pixs);
+extern void merge_block(component_video c1, component_video c2, 
+                        component_video c3, component_video c4, 
+                        quantized_values q);
+extern void split_block(quantized_values q, component_video c1, 
+                        component_video c2, component_video c3, 
+                        component_video c4);
 
 #endif
\ No newline at end of file
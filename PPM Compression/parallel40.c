@@ -0,0 +1,491 @@
+/*
+ *      parallel40.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Implementation for the parallel40.h file. The main thread reads the
+ *      image in stripes of STRIPE_ROWS scanlines as raw samples and hands
+ *      each stripe to the next free worker thread. A worker turns the
+ *      samples into pixels, quantizes its rows of blocks with block_rows.c
+ *      and packs their code words into the stripe. The main thread writes
+ *      the stripes out in order, so the output is the same bytes as
+ *      stream_compress40 gives. A few stripes per thread are read ahead,
+ *      so memory does not grow with the height of the image.
+ *      Every code word takes four bytes, so the code words of any row of
+ *      blocks start at a known offset. Decompression gives each thread a
+ *      range of rows, which it reads with pread and decodes into its part
+ *      of one buffer holding the whole output image
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+/* CS40 Libraries */
+#include <pnm.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "parallel40.h"
+#include "compress_structs.h"
+#include "read_and_write.h"
+#include "final_bitpack.h"
+#include "block_rows.h"
+#include "stream40.h"
+
+/* Scanlines in a stripe; even, so that a stripe holds whole rows of blocks */
+static const unsigned STRIPE_ROWS = 32;
+
+/* Stripes that can be read or compressed but not yet written, per thread */
+static const unsigned STRIPES_PER_THREAD = 2;
+
+/* The denominator of decompressed images */
+static const unsigned RGB_DENOMINATOR = 255;
+
+/* Worker threads used; 0 means one for each online CPU */
+static unsigned worker_threads = 0;
+
+/**********struct stripe********
+ * About: This struct holds the scanlines of one stripe of the image as raw
+ *        samples and the code words of its blocks, with the number of
+ *        scanlines in it and whether a worker has compressed it
+************************/
+struct stripe {
+        unsigned rows;
+        unsigned char *samples;
+        unsigned char *codewords;
+        bool compressed;
+};
+
+/**********struct stripe_queue********
+ * About: This struct is shared by the main thread and the workers. Stripe
+ *        n of the image is kept in stripes[n % slots]. read counts the
+ *        stripes the main thread has read and taken the stripes workers
+ *        have started on. lock guards read, taken and compressed, and
+ *        changed is signalled whenever one of them changes
+************************/
+struct stripe_queue {
+        pthread_mutex_t lock;
+        pthread_cond_t changed;
+        ppm_header header;
+        unsigned blocks;
+        struct stripe *stripes;
+        unsigned slots;
+        unsigned read, taken, total;
+};
+
+/**********struct row_range********
+ * About: This struct holds the rows of blocks one decompressing thread 
+ *        decodes, from first up to but not including last. The code words
+ *        are read with pread from fd at offset codewords, or from words when
+ *        the input could not be read at an offset. pixels is the raw ppm
+ *        output of the whole image, width pixels wide
+************************/
+struct row_range {
+        int fd;
+        off_t codewords;
+        const unsigned char *words;
+        unsigned width;
+        unsigned first, last;
+        unsigned char *pixels;
+};
+
+unsigned thread_count(void);
+void *compress_stripes(void *queue);
+void compress_stripe(struct stripe_queue *queue, struct stripe *stripe,
+                     Pnm_rgb top, Pnm_rgb bottom, block_row_planes planes,
+                     quantized_values quantized);
+void *decompress_rows(void *range);
+
+
+/******************************* use_threads **********************************
+ *
+ * Sets the number of worker threads parallel_compress40 uses
+ *
+ * Inputs:
+ *              unsigned threads: the number of threads, or 0 for one thread
+ *                                for each online CPU
+ * Return:
+ *              none
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+void use_threads(unsigned threads)
+{
+        worker_threads = threads;
+}
+
+/******************************* thread_count *********************************
+ *
+ * Gives the number of threads to start, which is the number use_threads set
+ * or one for each online CPU
+ *
+ * Inputs:
+ *              none
+ * Return:
+ *              the number of threads, at least 1
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+unsigned thread_count(void)
+{
+        if (worker_threads > 0) {
+                return worker_threads;
+        }
+
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        return cpus > 0 ? cpus : 1;
+}
+
+/*************************** parallel_compress40 ******************************
+ *
+ * Compresses a ppm image on several threads and writes output to stdout
+ *
+ * Inputs:
+ *              FILE *input: The ppm image to compress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL
+ * Notes:
+ *              will CRE if expectations fail or a thread cannot be started
+ *              gives the same bytes as stream_compress40, with any number
+ *                      of threads
+ *              an odd last column or row is trimmed, as compress40 does
+ *
+ *****************************************************************************/
+void parallel_compress40(FILE *input)
+{
+        assert(input != NULL);
+
+        unsigned threads = thread_count();
+        struct stripe_queue queue;
+        queue.header = read_ppm_header(input);
+
+        /* If width or height is odd, trim the last column or row */
+        unsigned width = queue.header.width - queue.header.width % 2;
+        unsigned height = queue.header.height - queue.header.height % 2;
+        queue.blocks = width / 2;
+        queue.total = (height + STRIPE_ROWS - 1) / STRIPE_ROWS;
+        queue.read = queue.taken = 0;
+
+        /* Every slot can hold a full stripe */
+        queue.slots = threads * STRIPES_PER_THREAD;
+        queue.stripes = malloc(queue.slots * sizeof(struct stripe));
+        assert(queue.stripes != NULL);
+        size_t sample_bytes = ppm_sample_bytes(queue.header);
+        for (unsigned i = 0; i < queue.slots; i++) {
+                struct stripe *stripe = &queue.stripes[i];
+                stripe->samples = malloc(STRIPE_ROWS * sample_bytes + 1);
+                stripe->codewords = malloc(STRIPE_ROWS / 2 * queue.blocks *
+                                           CODEWORD_BYTES + 1);
+                assert(stripe->samples != NULL && stripe->codewords != NULL);
+                stripe->compressed = false;
+        }
+
+        /* The kernel is chosen before the workers share it */
+        choose_block_row_kernel();
+        pthread_mutex_init(&queue.lock, NULL);
+        pthread_cond_init(&queue.changed, NULL);
+        pthread_t *workers = malloc(threads * sizeof(pthread_t));
+        assert(workers != NULL);
+        for (unsigned i = 0; i < threads; i++) {
+                int failed = pthread_create(&workers[i], NULL,
+                                            compress_stripes, &queue);
+                assert(!failed);
+        }
+
+        /* Print output header */
+        printf("COMP40 Compressed image format 2\n%u %u\n", width, height);
+
+        /* Read ahead while there are free slots, then write the next stripe
+           once it is compressed, which frees its slot */
+        for (unsigned written = 0; written < queue.total; written++) {
+                while (queue.read < queue.total &&
+                       queue.read - written < queue.slots) {
+                        struct stripe *stripe =
+                                &queue.stripes[queue.read % queue.slots];
+                        unsigned first_row = queue.read * STRIPE_ROWS;
+                        stripe->rows = height - first_row < STRIPE_ROWS ?
+                                       height - first_row : STRIPE_ROWS;
+                        read_ppm_samples(input, queue.header, stripe->rows,
+                                         stripe->samples);
+
+                        pthread_mutex_lock(&queue.lock);
+                        queue.read++;
+                        pthread_cond_broadcast(&queue.changed);
+                        pthread_mutex_unlock(&queue.lock);
+                }
+
+                struct stripe *stripe = &queue.stripes[written % queue.slots];
+                pthread_mutex_lock(&queue.lock);
+                while (!stripe->compressed) {
+                        pthread_cond_wait(&queue.changed, &queue.lock);
+                }
+                stripe->compressed = false;
+                pthread_mutex_unlock(&queue.lock);
+
+                fwrite(stripe->codewords, CODEWORD_BYTES,
+                       stripe->rows / 2 * queue.blocks, stdout);
+        }
+
+        for (unsigned i = 0; i < threads; i++) {
+                pthread_join(workers[i], NULL);
+        }
+        pthread_mutex_destroy(&queue.lock);
+        pthread_cond_destroy(&queue.changed);
+
+        for (unsigned i = 0; i < queue.slots; i++) {
+                free(queue.stripes[i].samples);
+                free(queue.stripes[i].codewords);
+        }
+        free(queue.stripes);
+        free(workers);
+}
+
+/***************************** compress_stripes *******************************
+ *
+ * parallel_compress40 helper function - the body of a worker thread, which
+ * compresses the next stripe that no other worker has started until every
+ * stripe of the image has been started
+ *
+ * Inputs:
+ *              void *queue: the struct stripe_queue shared by the threads
+ * Return:
+ *              NULL
+ * Expects:
+ *              queue is not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void *compress_stripes(void *queue)
+{
+        assert(queue != NULL);
+        struct stripe_queue *q = queue;
+
+        /* The two scanlines and the quantized values of a row of blocks */
+        Pnm_rgb top = malloc(q->header.width * sizeof(struct Pnm_rgb) + 1);
+        Pnm_rgb bottom = malloc(q->header.width * sizeof(struct Pnm_rgb) + 1);
+        quantized_values quantized = malloc((q->blocks + 1) *
+                                            sizeof(struct quantized_values));
+        assert(top != NULL && bottom != NULL && quantized != NULL);
+        block_row_planes planes = block_row_planes_new(q->blocks);
+
+        pthread_mutex_lock(&q->lock);
+        while (q->taken < q->total) {
+                if (q->taken == q->read) {
+                        pthread_cond_wait(&q->changed, &q->lock);
+                        continue;
+                }
+                struct stripe *stripe = &q->stripes[q->taken % q->slots];
+                q->taken++;
+                pthread_mutex_unlock(&q->lock);
+
+                compress_stripe(q, stripe, top, bottom, planes, quantized);
+
+                pthread_mutex_lock(&q->lock);
+                stripe->compressed = true;
+                pthread_cond_broadcast(&q->changed);
+        }
+        pthread_mutex_unlock(&q->lock);
+
+        free(top);
+        free(bottom);
+        free(quantized);
+        block_row_planes_free(&planes);
+
+        return NULL;
+}
+
+/***************************** compress_stripe ********************************
+ *
+ * compress_stripes helper function - compresses the rows of blocks of one
+ * stripe and stores their code words in it
+ *
+ * Inputs:
+ *              struct stripe_queue *queue: the queue the stripe is from
+ *              struct stripe *stripe: the stripe to compress
+ *              Pnm_rgb top, bottom: room for two scanlines of pixels
+ *              block_row_planes planes: the scratch planes of this thread
+ *              quantized_values quantized: room for the quantized values of
+ *                                          a row of blocks
+ * Return:
+ *              none - the code words are stored in stripe
+ * Expects:
+ *              none of the inputs are null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void compress_stripe(struct stripe_queue *queue, struct stripe *stripe,
+                     Pnm_rgb top, Pnm_rgb bottom, block_row_planes planes,
+                     quantized_values quantized)
+{
+        assert(queue != NULL && stripe != NULL);
+        assert(top != NULL && bottom != NULL && quantized != NULL);
+
+        size_t sample_bytes = ppm_sample_bytes(queue->header);
+        unsigned char *samples = stripe->samples;
+        unsigned char *codewords = stripe->codewords;
+        for (unsigned row = 0; row < stripe->rows; row += 2) {
+                samples_to_ppm_row(samples, queue->header, top);
+                samples_to_ppm_row(samples + sample_bytes, queue->header,
+                                   bottom);
+                samples += 2 * sample_bytes;
+
+                compress_block_row(top, bottom, queue->blocks,
+                                   queue->header.denominator, planes,
+                                   quantized);
+                for (unsigned i = 0; i < queue->blocks; i++) {
+                        store_codeword(pack_fields(&quantized[i]),
+                                       codewords);
+                        codewords += CODEWORD_BYTES;
+                }
+        }
+}
+
+/************************** parallel_decompress40 *****************************
+ *
+ * Decompresses a compressed file back to ppm file format on several threads
+ *
+ * Inputs:
+ *              FILE *input: The file to decompress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL and holds every code word of the image
+ * Notes:
+ *              will CRE if expectations fail or a thread cannot be started
+ *              gives the same bytes as stream_decompress40, with any number
+ *                      of threads
+ *              the whole output image is held in memory; when input is a 
+ *                      pipe, all of its code words are too
+ *
+ *****************************************************************************/
+void parallel_decompress40(FILE *input)
+{
+        assert(input != NULL);
+
+        unsigned width, height;
+        read_compressed_header(input, &width, &height);
+        unsigned rows = height / 2;
+        size_t row_bytes = (size_t)width / 2 * CODEWORD_BYTES;
+        size_t scanline = (size_t)width * 3;
+
+        /* Code words are read at their offset in the file, or else all of 
+           them are read now */
+        int fd = fileno(input);
+        off_t codewords = ftello(input);
+        unsigned char *words = NULL;
+        if (codewords < 0 || lseek(fd, 0, SEEK_CUR) < 0) {
+                words = malloc(rows * row_bytes + 1);
+                assert(words != NULL);
+                size_t read = fread(words, 1, rows * row_bytes, input);
+                assert(read == rows * row_bytes);
+        }
+
+        unsigned char *pixels = malloc(height * scanline + 1);
+        assert(pixels != NULL);
+
+        /* Each thread decodes an equal share of the rows of blocks */
+        unsigned threads = thread_count();
+        pthread_t *workers = malloc(threads * sizeof(pthread_t));
+        struct row_range *ranges = malloc(threads * sizeof(struct row_range));
+        assert(workers != NULL && ranges != NULL);
+        for (unsigned i = 0; i < threads; i++) {
+                ranges[i].fd = fd;
+                ranges[i].codewords = codewords;
+                ranges[i].words = words;
+                ranges[i].width = width;
+                ranges[i].first = (uint64_t)rows * i / threads;
+                ranges[i].last = (uint64_t)rows * (i + 1) / threads;
+                ranges[i].pixels = pixels;
+                int failed = pthread_create(&workers[i], NULL,
+                                            decompress_rows, &ranges[i]);
+                assert(!failed);
+        }
+        for (unsigned i = 0; i < threads; i++) {
+                pthread_join(workers[i], NULL);
+        }
+
+        write_ppm_header(width, height, RGB_DENOMINATOR);
+        fwrite(pixels, 1, height * scanline, stdout);
+
+        free(words);
+        free(pixels);
+        free(workers);
+        free(ranges);
+}
+
+/***************************** decompress_rows ********************************
+ *
+ * parallel_decompress40 helper function - the body of a thread, which 
+ * decodes a range of rows of blocks into the output image
+ *
+ * Inputs:
+ *              void *range: the struct row_range to decode
+ * Return:
+ *              NULL
+ * Expects:
+ *              range is not null and the file holds the code words of its
+ *              rows
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void *decompress_rows(void *range)
+{
+        assert(range != NULL);
+        struct row_range *r = range;
+
+        unsigned blocks = r->width / 2;
+        size_t row_bytes = (size_t)blocks * CODEWORD_BYTES;
+        size_t scanline = (size_t)r->width * 3;
+
+        /* The two scanlines and the code words of a row of blocks */
+        Pnm_rgb top = malloc(r->width * sizeof(struct Pnm_rgb) + 1);
+        Pnm_rgb bottom = malloc(r->width * sizeof(struct Pnm_rgb) + 1);
+        unsigned char *buffer = malloc(row_bytes + 1);
+        assert(top != NULL && bottom != NULL && buffer != NULL);
+
+        for (unsigned row = r->first; row < r->last; row++) {
+                const unsigned char *words;
+                if (r->words != NULL) {
+                        words = r->words + row * row_bytes;
+                } else {
+                        ssize_t read = pread(r->fd, buffer, row_bytes,
+                                             r->codewords + row * row_bytes);
+                        assert(read >= 0 && (size_t)read == row_bytes);
+                        words = buffer;
+                }
+
+                for (unsigned i = 0; i < blocks; i++) {
+                        decompress_block(load_codeword(&words[i * 
+                                                       CODEWORD_BYTES]),
+                                         &top[2 * i], &bottom[2 * i]);
+                }
+                unsigned char *pixels = r->pixels + 2 * row * scanline;
+                store_ppm_row(top, r->width, pixels);
+                store_ppm_row(bottom, r->width, pixels + scanline);
+        }
+
+        free(top);
+        free(bottom);
+        free(buffer);
+
+        return NULL;
+}
@@ -0,0 +1,22 @@
+/*
+ *      parallel40.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Interface for the parallel40.c file. Functions in this file compress
+ *      a ppm image on several threads, one horizontal stripe of the image at
+ *      a time on each, and decompress a compressed file on several threads,
+ *      each decoding a range of rows of blocks
+ */
+
+#ifndef PARALLEL40_INCLUDED
+#define PARALLEL40_INCLUDED
+
+/* Standard C Libraries */
+#include <stdio.h>
+
+extern void use_threads(unsigned threads);
+extern void parallel_compress40(FILE *input);
+extern void parallel_decompress40(FILE *input);
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ *      planar.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Implementation for the planar.h file. Functions in this file create,
+ *      free and index planar images
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "planar.h"
+
+/* Rows are padded to a multiple of this many floats (32 bytes), so that
+   every row starts as aligned as the plane */
+static const int ROW_ALIGN = 8;
+
+
+/******************************** planar_new **********************************
+ *
+ * Creates a planar image with three planes of width by height floats
+ *
+ * Inputs:
+ *              int width: the number of pixels in a row
+ *              int height: the number of rows
+ * Return:
+ *              the new planar image, with its floats not initialized
+ * Expects:
+ *              width and height to be greater than or equal to 0
+ * Notes:
+ *              will CRE if expectations fail or memory cannot be allocated
+ *              it is the resposibility of the user to free the image using
+ *                      planar_free
+ *
+ *****************************************************************************/
+planar_image planar_new(int width, int height)
+{
+        assert(width >= 0 && height >= 0);
+
+        planar_image image = malloc(sizeof(struct planar_image));
+        assert(image != NULL);
+        image->width = width;
+        image->height = height;
+        image->stride = (width + ROW_ALIGN - 1) / ROW_ALIGN * ROW_ALIGN;
+
+        /* One extra float keeps malloc from being asked for 0 bytes */
+        size_t floats = (size_t)image->stride * height + 1;
+        for (int p = 0; p < 3; p++) {
+                image->plane[p] = malloc(floats * sizeof(float));
+                assert(image->plane[p] != NULL);
+        }
+
+        return image;
+}
+
+/******************************** planar_free *********************************
+ *
+ * Frees a planar image and its planes
+ *
+ * Inputs:
+ *              planar_image *image: pointer to the image to free
+ * Return:
+ *              none - *image is set to NULL
+ * Expects:
+ *              image and *image not to be null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void planar_free(planar_image *image)
+{
+        assert(image != NULL && *image != NULL);
+
+        for (int p = 0; p < 3; p++) {
+                free((*image)->plane[p]);
+        }
+        free(*image);
+        *image = NULL;
+}
+
+/******************************** planar_row **********************************
+ *
+ * Gives the first float of a row of one plane
+ *
+ * Inputs:
+ *              planar_image image: the image
+ *              int plane: the plane, 0 to 2
+ *              int row: the row, 0 to height - 1
+ * Return:
+ *              pointer to the width floats of the row
+ * Expects:
+ *              image not to be null and plane and row to be in range
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+float *planar_row(planar_image image, int plane, int row)
+{
+        assert(image != NULL);
+        assert(plane >= 0 && plane < 3);
+        assert(row >= 0 && row < image->height);
+
+        return image->plane[plane] + (size_t)row * image->stride;
+}
@@ -0,0 +1,31 @@
+/*
+ *      planar.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Interface for the planar.c file. A planar_image holds three float 
+ *      values per pixel in three separate planes, one for each of R, G, B or
+ *      of Y, Pb, Pr, so that math on one channel reads consecutive floats
+ */
+
+#ifndef PLANAR_INCLUDED
+#define PLANAR_INCLUDED
+
+/* Planes of an image holding unscaled rgb floats */
+enum { PLANE_R = 0, PLANE_G = 1, PLANE_B = 2 };
+
+/* Planes of an image holding component video floats */
+enum { PLANE_Y = 0, PLANE_PB = 1, PLANE_PR = 2 };
+
+/* Each plane is height rows of stride floats, of which the first width are
+   pixels; a row starts at plane[p] + row * stride */
+typedef struct planar_image {
+        int width, height, stride;
+        float *plane[3];
+} *planar_image;
+
+extern planar_image planar_new(int width, int height);
+extern void planar_free(planar_image *image);
+extern float *planar_row(planar_image image, int plane, int row);
+
+#endif
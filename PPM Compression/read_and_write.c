@@ -8,6 +8,9 @@
  *      are used to convert between ppm files and Pnm_ppm structs
  */
 
+/* Standard C Libraries */
+#include <ctype.h>
+
 /* CS40 Libraries */
 #include <a2blocked.h>
 
@@ -17,6 +20,13 @@
 /* Custom .h files */
 #include "read_and_write.h"
 
+unsigned read_ppm_number(FILE *input);
+
+/* Largest denominator a ppm file can have */
+static const unsigned PPM_MAX_DENOMINATOR = 65535;
+
+/* Largest denominator whose samples take one byte in a raw ppm file */
+static const unsigned PPM_BYTE_MAX = 255;
 
 /******************************* read_ppm *********************************
  *
@@ -78,4 +88,284 @@ void write_ppm(Pnm_ppm image)
         /* print out the resulting image and free the Pnm_ppm instance */
         Pnm_ppmwrite(stdout, image);
         Pnm_ppmfree(&image);
-}
\ No newline at end of file
+}
+
+/**************************** read_ppm_header *********************************
+ *
+ * Reads the header of a ppm file, up to the first byte of its pixels, so that
+ * the pixels can be read a few scanlines at a time with read_ppm_samples
+ *
+ * Inputs:
+ *              FILE *input: pointer to the file to read the header from
+ * Return:
+ *              ppm_header holding the width, height and denominator of the
+ *              image and whether its pixels are raw (P6) or plain (P3)
+ * Expects:
+ *              input file pointer not to be null
+ *              the file to start with a P3 or P6 ppm header whose 
+ *                      denominator is between 1 and 65535
+ * Notes:
+ *              will CRE if expectations fail
+ *              accepts the same comments between header fields as 
+ *                      Pnm_ppmread
+ *
+ *****************************************************************************/
+ppm_header read_ppm_header(FILE *input)
+{
+        assert(input != NULL);
+
+        /* Read in the magic number */
+        int p = getc(input);
+        int kind = getc(input);
+        assert(p == 'P' && (kind == '6' || kind == '3'));
+
+        /* Read in the size and denominator */
+        ppm_header header;
+        header.raw = (kind == '6');
+        header.width = read_ppm_number(input);
+        header.height = read_ppm_number(input);
+        header.denominator = read_ppm_number(input);
+        assert(header.denominator > 0 && 
+               header.denominator <= PPM_MAX_DENOMINATOR);
+
+        /* A single whitespace character separates the header from pixels */
+        int c = getc(input);
+        assert(c != EOF && isspace(c));
+
+        return header;
+}
+
+/**************************** ppm_sample_bytes ********************************
+ *
+ * Gives the number of bytes one scanline takes as raw samples
+ *
+ * Inputs:
+ *              ppm_header header: the header read_ppm_header returned
+ * Return:
+ *              the number of bytes of a scanline of raw samples, as a P6
+ *              file stores them
+ * Expects:
+ *              none
+ * Notes:
+ *              a sample takes two bytes when the denominator is larger 
+ *                      than 255
+ *
+ *****************************************************************************/
+size_t ppm_sample_bytes(ppm_header header)
+{
+        size_t sample = header.denominator > PPM_BYTE_MAX ? 2 : 1;
+
+        return (size_t)header.width * 3 * sample;
+}
+
+/**************************** read_ppm_samples ********************************
+ *
+ * Reads the next scanlines of a ppm file whose header has been read, as raw
+ * samples, so that they can be turned into pixels later or by another thread
+ *
+ * Inputs:
+ *              FILE *input: pointer to the file to read the scanlines from
+ *              ppm_header header: the header read_ppm_header returned
+ *              unsigned rows: the number of scanlines to read
+ *              unsigned char *samples: rows * ppm_sample_bytes(header) bytes
+ *                                      to fill in
+ * Return:
+ *              none - the samples are stored in samples
+ * Expects:
+ *              input and samples not to be null
+ *              the file to hold rows full scanlines
+ *              plain (P3) samples to be at most the denominator
+ * Notes:
+ *              will CRE if expectations fail
+ *              raw (P6) scanlines are copied with one fread; plain ones are
+ *                      parsed and stored the way a P6 file would store them
+ *
+ *****************************************************************************/
+void read_ppm_samples(FILE *input, ppm_header header, unsigned rows,
+                      unsigned char *samples)
+{
+        assert(input != NULL);
+        assert(samples != NULL);
+
+        size_t bytes = rows * ppm_sample_bytes(header);
+        if (header.raw) {
+                size_t read = fread(samples, 1, bytes, input);
+                assert(read == bytes);
+                return;
+        }
+
+        size_t i = 0;
+        while (i < bytes) {
+                unsigned sample = read_ppm_number(input);
+                assert(sample <= header.denominator);
+                if (header.denominator > PPM_BYTE_MAX) {
+                        samples[i++] = sample >> 8;
+                }
+                samples[i++] = sample & PPM_BYTE_MAX;
+        }
+}
+
+/**************************** samples_to_ppm_row ******************************
+ *
+ * Turns one scanline of raw samples into pixels
+ *
+ * Inputs:
+ *              const unsigned char *samples: ppm_sample_bytes(header) bytes
+ *                                            of raw samples
+ *              ppm_header header: the header read_ppm_header returned
+ *              Pnm_rgb row: array of header.width pixels to fill in
+ * Return:
+ *              none - the pixels are stored in row
+ * Expects:
+ *              samples and row not to be null
+ * Notes:
+ *              will CRE if expectations fail
+ *              gives the pixels a Pnm_ppmread of the file would hold
+ *
+ *****************************************************************************/
+void samples_to_ppm_row(const unsigned char *samples, ppm_header header,
+                        Pnm_rgb row)
+{
+        assert(samples != NULL);
+        assert(row != NULL);
+
+        if (header.denominator > PPM_BYTE_MAX) {
+                for (unsigned col = 0; col < header.width; col++) {
+                        row[col].red = (samples[0] << 8) | samples[1];
+                        row[col].green = (samples[2] << 8) | samples[3];
+                        row[col].blue = (samples[4] << 8) | samples[5];
+                        samples += 6;
+                }
+                return;
+        }
+
+        for (unsigned col = 0; col < header.width; col++) {
+                row[col].red = samples[0];
+                row[col].green = samples[1];
+                row[col].blue = samples[2];
+                samples += 3;
+        }
+}
+
+/**************************** read_ppm_number *********************************
+ *
+ * read_ppm_header and read_ppm_samples helper function - reads a decimal
+ * number, skipping whitespace and comments before it
+ *
+ * Inputs:
+ *              FILE *input: pointer to the file to read the number from
+ * Return:
+ *              the number read
+ * Expects:
+ *              input not to be null and the next field to be a number
+ * Notes:
+ *              will CRE if expectations fail
+ *              the character after the number is left in the stream
+ *
+ *****************************************************************************/
+unsigned read_ppm_number(FILE *input)
+{
+        assert(input != NULL);
+
+        /* Skip whitespace and comments, which run to the end of a line */
+        int c = getc(input);
+        while (isspace(c) || c == '#') {
+                if (c == '#') {
+                        while (c != '\n' && c != EOF) {
+                                c = getc(input);
+                        }
+                }
+                c = getc(input);
+        }
+        assert(c != EOF && isdigit(c));
+
+        unsigned number = 0;
+        while (c != EOF && isdigit(c)) {
+                number = number * 10 + (c - '0');
+                c = getc(input);
+        }
+        ungetc(c, input);
+
+        return number;
+}
+
+/**************************** write_ppm_header ********************************
+ *
+ * Writes the header of a raw ppm image to stdout, so that its pixels can be
+ * written one scanline at a time with write_ppm_row
+ *
+ * Inputs:
+ *              unsigned width: the width of the image
+ *              unsigned height: the height of the image
+ *              unsigned denominator: the denominator of the image
+ * Return:
+ *              none - all output is sent to stdout
+ * Expects:
+ *              denominator to be between 1 and 255
+ * Notes:
+ *              will CRE if expectations fail
+ *              writes the same header as Pnm_ppmwrite
+ *
+ *****************************************************************************/
+void write_ppm_header(unsigned width, unsigned height, unsigned denominator)
+{
+        assert(denominator > 0 && denominator <= PPM_BYTE_MAX);
+
+        printf("P6\n%u %u\n%u\n", width, height, denominator);
+}
+
+/***************************** write_ppm_row **********************************
+ *
+ * Writes one scanline of a raw ppm image to stdout, after write_ppm_header
+ *
+ * Inputs:
+ *              Pnm_rgb row: array of the pixels in the scanline
+ *              unsigned width: the number of pixels in the scanline
+ * Return:
+ *              none - all output is sent to stdout
+ * Expects:
+ *              row not to be null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void write_ppm_row(Pnm_rgb row, unsigned width)
+{
+        assert(row != NULL);
+
+        for (unsigned col = 0; col < width; col++) {
+                putchar(row[col].red);
+                putchar(row[col].green);
+                putchar(row[col].blue);
+        }
+}
+
+/***************************** store_ppm_row **********************************
+ *
+ * Stores one scanline of a raw ppm image in memory, as write_ppm_row writes
+ * it to stdout
+ *
+ * Inputs:
+ *              Pnm_rgb row: array of the pixels in the scanline
+ *              unsigned width: the number of pixels in the scanline
+ *              unsigned char *bytes: where the 3 * width bytes are stored
+ * Return:
+ *              none - the scanline is stored in bytes
+ * Expects:
+ *              row and bytes not to be null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void store_ppm_row(Pnm_rgb row, unsigned width, unsigned char *bytes)
+{
+        assert(row != NULL);
+        assert(bytes != NULL);
+
+        for (unsigned col = 0; col < width; col++) {
+                bytes[0] = row[col].red;
+                bytes[1] = row[col].green;
+                bytes[2] = row[col].blue;
+                bytes += 3;
+        }
+}
@@ -14,11 +14,28 @@
 /* Standard C Libraries */
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
 
 /* CS40 Libraries */
 #include <pnm.h>
 
+/* Size and format of a ppm file that is read one scanline at a time */
+typedef struct ppm_header {
+        unsigned width, height, denominator;
+        bool raw;
+} ppm_header;
+
 extern Pnm_ppm read_ppm(FILE *input);
 extern void write_ppm(Pnm_ppm image);
+extern ppm_header read_ppm_header(FILE *input);
+extern size_t ppm_sample_bytes(ppm_header header);
+extern void read_ppm_samples(FILE *input, ppm_header header, unsigned rows,
+                             unsigned char *samples);
+extern void samples_to_ppm_row(const unsigned char *samples, 
+                               ppm_header header, Pnm_rgb row);
+extern void write_ppm_header(unsigned width, unsigned height, 
+                             unsigned denominator);
+extern void write_ppm_row(Pnm_rgb row, unsigned width);
+extern void store_ppm_row(Pnm_rgb row, unsigned width, unsigned char *bytes);
 
 #endif
@@ -20,13 +20,14 @@
 
 /* Helper function declarations */
 void compress_apply(int col, int row, A2Methods_UArray2 array2b, void *elem, 
-                      void *image);
+                      void *params);
 void find_max_apply(int col, int row, A2Methods_UArray2 array2b, void *elem, 
                       void *max);
 void find_min_apply(int col, int row, A2Methods_UArray2 array2b, void *elem, 
                      void *min);
 void decompress_apply(int col, int row, A2Methods_UArray2 array2b, void *elem, 
                       void *param);
+float truncate_unit(float num);
 
 
 
@@ -43,62 +44,58 @@ struct decompress_parameters {
         float min;
 };
 
+/**********struct compress_parameters********
+ * About: This struct holds the planar image that compress_apply fills in and
+ *        the denominator of the scaled integers it reads
+************************/
+struct compress_parameters {
+        planar_image rgb;
+        float denominator;
+};
+
 /* The denominator value for the scaled RGB values */
 static const float RGB_MAX = 255.0;
 
 /************************** compress_rgb_conversion ***************************
  *
- * Updates the A2Methods_UArray2 that the Pnm_ppm struct holds so that the RGB 
- * values are floats instead of scaled integers. Also trims the 
- * A2Methods_UArray2 by a column or row if the width or height is an odd number
+ * Converts the RGB scaled integers of the Pnm_ppm struct to unscaled floats
+ * in a planar image, with one plane each for red, green and blue. Also trims
+ * a column or row if the width or height is an odd number
  *
  * Inputs:
  *              Pnm_ppm image: struct that holds the A2Methods_UArray2 storing 
  *                             RGB scaled integer values, A2Methods_T suite and
  *                             other information regarding the image.
  * Return:
- *              none - only the Pnm_ppm image is updated
+ *              planar_image holding the unscaled floats
  * Expects:
  *              Pnm_ppm image not to be null
  * Notes:
  *              will CRE if expectations fail
- *              it is the resposibility of the user to free the Pnm_ppm struct
- *                      they input using the Pnm_ppmfree function
+ *              the user accepts that Pnm_ppm image is freed
+ *              it is the resposibility of the user to free the returned
+ *                      planar image using planar_free
  *
  *****************************************************************************/
-void compress_rgb_conversion(Pnm_ppm image) 
+planar_image compress_rgb_conversion(Pnm_ppm image) 
 {
         assert(image != NULL);
-        
-        /* Access to the pixel array and width and height information */
-        A2Methods_UArray2 pixels_int = image->pixels;
-        assert(pixels_int != NULL);
-        int new_width = image->width;
-        int new_height = image->height;
+        assert(image->pixels != NULL);
 
-        /* If width or height is odd, update new width/height values to trim */
-        if (image->width % 2 != 0) {
-                new_width--;
-        }
-        if (image->height % 2 != 0) {
-                new_height--;
-        }
+        /* If width or height is odd, trim the last column or row */
+        int new_width = image->width - image->width % 2;
+        int new_height = image->height - image->height % 2;
 
-        /* Initialize new A2Methods_UArray2 to hold RGB floats */
-        A2Methods_UArray2 pixels_float = image->methods->new(new_width, 
-                                    new_height, sizeof(struct Pnm_rgb_float));
-        assert(pixels_float != NULL);
-
-        /* Update image members so they hold the new float pixel info */
-        image->pixels = pixels_float;
-        image->width = new_width;
-        image->height = new_height;
+        /* Fill the planes by using the RGB values from the image */
+        planar_image rgb = planar_new(new_width, new_height);
+        struct compress_parameters params = {rgb, image->denominator};
+        image->methods->map_block_major(image->pixels, compress_apply, 
+                                        &params);
 
-        /* Fill pixels_float cells by using the RGB values from pixels_int */
-        image->methods->map_block_major(pixels_int, compress_apply, image);
+        /* Free the image that held RGB scaled integer info */
+        Pnm_ppmfree(&image);
 
-        /* Free the array that held RGB scaled integer info */
-        image->methods->free(&pixels_int);
+        return rgb;
 }
 
 /*************************** compress_apply ***********************************
@@ -114,41 +111,75 @@ void compress_rgb_conversion(Pnm_ppm image)
  *                                         scaled integer rgb values in Pnm_rgb
  *                                         structs)
  *              void: *elem: The element at the index [col, row] in the UArray2
- *              void: *image: The UArray2 that we are mapping into (contains
- *                            unscaled float rgb values in Pnm_rgb_float 
- *                            structs)
+ *              void: *params: compress_parameters struct holding the planar
+ *                             image that we are mapping into and the 
+ *                             denominator of the scaled integers
  * Return:
- *              none - the UArray2s that we update are passed by reference
+ *              none - the planar image is updated
  * Expects:
- *              array2b, elem, and image are not null
+ *              array2b, elem, and params are not null
  * Notes:
  *              will CRE if expectations fail
  *
  *****************************************************************************/
 void compress_apply(int col, int row, A2Methods_UArray2 array2b, void *elem, 
-                      void *image)
+                      void *params)
 {
         assert(array2b != NULL);
         assert(elem != NULL);
-        assert(image != NULL);
+        assert(params != NULL);
         
-        /* Load in info about the UArray2 we are mapping to */
-        Pnm_ppm new_image = image;
-        A2Methods_UArray2 pixels_float = new_image->pixels;
-        float d = new_image->denominator;
-        int width = new_image->width;
-        int height = new_image->height;
+        /* Load in info about the planar image we are mapping to */
+        struct compress_parameters *prm = params;
+        planar_image rgb = prm->rgb;
 
         /* Cast currect elem void pointer */
         Pnm_rgb curr_pix = elem;
 
         /* Map rgb values from scaled integers to unscaled floats */
-        if (col < width && row < height) {
-                Pnm_rgb_float new_pixel = new_image->methods->at(pixels_float,
-                                                             col, row);
-                new_pixel->red = ((float) curr_pix->red) / d;
-                new_pixel->green = ((float) curr_pix->green) / d;
-                new_pixel->blue = ((float) curr_pix->blue) / d;
+        if (col < rgb->width && row < rgb->height) {
+                planar_row(rgb, PLANE_R, row)[col] = 
+                        ((float) curr_pix->red) / prm->denominator;
+                planar_row(rgb, PLANE_G, row)[col] = 
+                        ((float) curr_pix->green) / prm->denominator;
+                planar_row(rgb, PLANE_B, row)[col] = 
+                        ((float) curr_pix->blue) / prm->denominator;
+        }
+}
+
+/**************************** rgb_row_to_planar *******************************
+ *
+ * Converts one scanline of scaled integer rgb values to unscaled floats in a
+ * row of a planar image
+ *
+ * Inputs:
+ *              Pnm_rgb pixels: array of at least rgb->width pixels
+ *              float denominator: the denominator the pixels are scaled by
+ *              planar_image rgb: the planar image to store the floats in
+ *              int row: the row of rgb to store the floats in
+ * Return:
+ *              none - the floats are stored in row of rgb
+ * Expects:
+ *              pixels and rgb are not null and row is a row of rgb
+ * Notes:
+ *              will CRE if expectations fail
+ *              computes the same floats as compress_apply
+ *
+ *****************************************************************************/
+void rgb_row_to_planar(Pnm_rgb pixels, float denominator, planar_image rgb, 
+                       int row)
+{
+        assert(pixels != NULL);
+        assert(rgb != NULL);
+
+        float *red = planar_row(rgb, PLANE_R, row);
+        float *green = planar_row(rgb, PLANE_G, row);
+        float *blue = planar_row(rgb, PLANE_B, row);
+
+        for (int col = 0; col < rgb->width; col++) {
+                red[col] = ((float) pixels[col].red) / denominator;
+                green[col] = ((float) pixels[col].green) / denominator;
+                blue[col] = ((float) pixels[col].blue) / denominator;
         }
 }
 
@@ -354,3 +385,55 @@ void decompress_apply(int col, int row, A2Methods_UArray2 array2b, void *elem,
         new_pixel->blue = (unsigned)((curr_pix->blue - min) * 
                                      (RGB_MAX / scaling_factor));
 }
+
+/****************************** float_to_rgb **********************************
+ *
+ * Converts one pixel from unscaled float rgb values to integer rgb values 
+ * scaled by RGB_MAX, without the min/max rescaling that 
+ * decompress_rgb_conversion does
+ *
+ * Inputs:
+ *              Pnm_rgb_float pixel: the unscaled float pixel to convert
+ *              Pnm_rgb result: where the scaled integer values are stored
+ * Return:
+ *              none - the scaled integers are stored in result
+ * Expects:
+ *              pixel and result are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *              values outside of 0 to 1 are truncated to that range first
+ *
+ *****************************************************************************/
+void float_to_rgb(Pnm_rgb_float pixel, Pnm_rgb result)
+{
+        assert(pixel != NULL);
+        assert(result != NULL);
+
+        result->red = (unsigned)(truncate_unit(pixel->red) * RGB_MAX);
+        result->green = (unsigned)(truncate_unit(pixel->green) * RGB_MAX);
+        result->blue = (unsigned)(truncate_unit(pixel->blue) * RGB_MAX);
+}
+
+/****************************** truncate_unit **********************************
+ *
+ * float_to_rgb helper function - truncates a float to the range 0 to 1
+ *
+ * Inputs:
+ *              float num: value to be truncated
+ * Return:
+ *              0 if num is below 0, 1 if num is above 1, num otherwise
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+float truncate_unit(float num)
+{
+        if (num < 0.0) {
+                return 0.0;
+        } else if (num > 1.0) {
+                return 1.0;
+        }
+        return num;
+}
@@ -14,7 +14,14 @@
 /* CS40 Libraries */
 #include <pnm.h>
 
-extern void compress_rgb_conversion(Pnm_ppm image);
+/* Custom .h files */
+#include "compress_structs.h"
+#include "planar.h"
+
+extern planar_image compress_rgb_conversion(Pnm_ppm image);
 extern void decompress_rgb_conversion(Pnm_ppm image);
+extern void rgb_row_to_planar(Pnm_rgb pixels, float denominator, 
+                              planar_image rgb, int row);
+extern void float_to_rgb(Pnm_rgb_float pixel, Pnm_rgb result);
 
 #endif
\ No newline at end of file
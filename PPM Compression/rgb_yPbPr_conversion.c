@@ -11,6 +11,7 @@
 
 /* Standard C Libraries*/
 #include <stdlib.h>
+#include <stdbool.h>
 
 /* CS40 Libraries */
 #include <a2blocked.h>
@@ -24,11 +25,13 @@
 #include "rgb_yPbPr_conversion.h"
 #include "compress_structs.h"
 
-void compress_yPbPr_apply(int col, int row, A2Methods_UArray2 array2b,  
-                          void *elem, void *component_pixels);
 float calc_y(float r, float g, float b);
 float calc_pb(float r, float g, float b);
 float calc_pr(float r, float g, float b);
+static bool convert_row(int width, const float *restrict red,
+                        const float *restrict green,
+                        const float *restrict blue, float *restrict y,
+                        float *restrict pb, float *restrict pr);
 
 void decompress_yPbPr_apply(int col, int row, A2Methods_UArray2 array2b,  
                           void *elem, void *component_pixels);
@@ -40,7 +43,7 @@ float calc_g(float y, float pb, float pr);
 /**********struct compress_parameters********
  * About: This struct hold the parameters A2Methods_UArray2 pixels and its
  *        A2Methods_T methods. They are grouped together to allow them to
- *        be passed together into mapping functions during compression steps
+ *        be passed together into mapping functions during decompression steps
 ************************/
 struct compress_parameters {
         A2Methods_UArray2 pixels;
@@ -60,97 +63,112 @@ static const float RGB_UNSCALED_MIN = 0.0;
 
 /************************* compress_yPbPr_conversion **************************
  *
- * Uses the A2Methods_UArray2 that the Pnm_ppm struct holds to extract RGB 
- * float values and calculate component video floats Y, Pb, and Pr. Returns the
- * newly calculated values in a A2Methods_UArray2 with 2 by 2 blocks. 
+ * Converts the RGB float planes of a planar image to component video Y, Pb,
+ * and Pr planes in a new planar image
  *
  * Inputs:
- *              Pnm_ppm image: struct that holds the A2Methods_UArray2 storing 
- *                             RGB unscaled float values, A2Methods_T suite and
- *                             other information regarding the image.
+ *              planar_image rgb: planar image holding unscaled rgb floats in
+ *                                its PLANE_R, PLANE_G and PLANE_B planes
  * Return:
- *              A2Methods_UArray2 component_pixels that store Y, Pb, Pr values
+ *              planar_image holding Y, Pb and Pr in its PLANE_Y, PLANE_PB 
+ *              and PLANE_PR planes
  * Expects:
- *              Pnm_ppm image not to be null
+ *              planar_image rgb not to be null
  * Notes:
  *              will CRE if expectations fail
- *              the user accepts that Pnm_ppm image is freed
- *              it is the resposibility of the user to free the 
- *                      returned component_pixels array
+ *              the user accepts that planar_image rgb is freed
+ *              it is the resposibility of the user to free the returned 
+ *                      planar image using planar_free
  *
  *****************************************************************************/
-A2Methods_UArray2 compress_yPbPr_conversion(Pnm_ppm image) 
+planar_image compress_yPbPr_conversion(planar_image rgb) 
 {
-        assert(image != NULL);
-
-        /* Load in image information */
-        A2Methods_UArray2 pixels = image->pixels;
-        int width = image->width;
-        int height = image->height;
-
-        /* Initialize method suite */
-        A2Methods_T methods = uarray2_methods_blocked;
-        assert(methods != NULL && pixels != NULL);
+        assert(rgb != NULL);
 
-        /* Initialize 2-by-2 blocked array for component video variables */
-        A2Methods_UArray2 component_pixels = methods->new_with_blocksize(width,
-                                    height, sizeof(struct component_video), 2);
-        assert(component_pixels != NULL);
-
-        /* Traverse RGB values and store them as y/pb/pr values in new array */
-        struct compress_parameters params = {component_pixels, methods};                    
-        methods->map_block_major(pixels, compress_yPbPr_apply, &params);
-
-        /* Free the image struct */
-        Pnm_ppmfree(&image);
+        /* Convert one row of every plane at a time */
+        planar_image component = planar_new(rgb->width, rgb->height);
+        for (int row = 0; row < rgb->height; row++) {
+                rgb_to_component_row(rgb, component, row);
+        }
 
-        return component_pixels;
+        planar_free(&rgb);
 
+        return component;
 }
 
-/*********************** compress_yPbPr_apply *********************************
+/************************** rgb_to_component_row ******************************
  *
- * compress_yPbPr_conversion helper function - used when mapping through the 2D
- * UArray of pixels to convert from unscaled rgb floats to Y, Pb, Pr floats
+ * Converts one row of unscaled rgb float planes to Y, Pb, Pr float planes
  *
  * Inputs:
- *              int col: The current column in the UArray2
- *              int row: The current row in the UArray2
- *              A2Methods_UArray2 array2b: The UArray2 to traverse (contains
- *                                         unscaled float rgb values in
- *                                         Pnm_rgb_float structs)
- *              void: *elem: The element at the index [col, row] in the UArray2
- *              void: *params: Struct containing the UArray2 that we are 
- *                             mapping into (contains unscaled float Y, Pb, Pr 
- *                             values in component_video structs) and its
- *                             associated methods suite
+ *              planar_image rgb: planar image holding unscaled rgb floats
+ *              planar_image component: planar image to store Y, Pb and Pr in
+ *              int row: the row to convert
  * Return:
- *              none - the UArray2s that we update are passed by reference
+ *              none - the Y, Pb, Pr values are stored in row of component
  * Expects:
- *              array2b, elem, and params are not null
+ *              rgb and component are not null and have the same width
+ *              the rgb floats of the row to be in the range 0 to 1
  * Notes:
  *              will CRE if expectations fail
  *
  *****************************************************************************/
-void compress_yPbPr_apply(int col, int row, A2Methods_UArray2 array2b,  
-                          void *elem, void *params)
+void rgb_to_component_row(planar_image rgb, planar_image component, int row)
 {
-        assert(array2b != NULL);
-        assert(elem != NULL);
-        assert(params != NULL);
-        
-        /* Dereferences the UArray2, its methods, and the current elem*/
-        struct compress_parameters *compress_prm = params;
-        Pnm_rgb_float curr_pix = elem;
-        A2Methods_UArray2 comp_pix = compress_prm->pixels;
-        A2Methods_T methods = compress_prm->methods;
+        assert(rgb != NULL && component != NULL);
+        assert(rgb->width == component->width);
+
+        bool in_range = convert_row(rgb->width,
+                                    planar_row(rgb, PLANE_R, row),
+                                    planar_row(rgb, PLANE_G, row),
+                                    planar_row(rgb, PLANE_B, row),
+                                    planar_row(component, PLANE_Y, row),
+                                    planar_row(component, PLANE_PB, row),
+                                    planar_row(component, PLANE_PR, row));
+        assert(in_range);
+}
+
+/******************************** convert_row *********************************
+ *
+ * Checks the range of width rgb floats and converts them to Y, Pb, Pr floats
+ *
+ * Inputs:
+ *              int width: the number of pixels in the row
+ *              const float *red, *green, *blue: the rgb floats of the row
+ *              float *y, *pb, *pr: where the Y, Pb, Pr floats are stored
+ * Return:
+ *              true if every rgb float is in the range 0 to 1
+ * Expects:
+ *              the six rows not to overlap
+ * Notes:
+ *              the rows are restrict parameters and the range is kept in an
+ *                      int with no branches, so gcc -O3 vectorizes both loops
+ *
+ *****************************************************************************/
+static bool convert_row(int width, const float *restrict red,
+                        const float *restrict green,
+                        const float *restrict blue, float *restrict y,
+                        float *restrict pb, float *restrict pr)
+{
+        /* Make sure rgb values are in the correct range */
+        int in_range = 1;
+        for (int col = 0; col < width; col++) {
+                in_range &= (red[col] >= RGB_UNSCALED_MIN) &
+                            (red[col] <= RGB_UNSCALED_MAX) &
+                            (green[col] >= RGB_UNSCALED_MIN) &
+                            (green[col] <= RGB_UNSCALED_MAX) &
+                            (blue[col] >= RGB_UNSCALED_MIN) &
+                            (blue[col] <= RGB_UNSCALED_MAX);
+        }
 
         /* Calculates and stores the Y, Pb, Pr values */
-        struct component_video *new_pixel = methods->at(comp_pix, col, row);
-        new_pixel->y = calc_y(curr_pix->red, curr_pix->green, curr_pix->blue);
-        new_pixel->pb = calc_pb(curr_pix->red, curr_pix->green, curr_pix->blue);
-        new_pixel->pr = calc_pr(curr_pix->red, curr_pix->green, curr_pix->blue);
+        for (int col = 0; col < width; col++) {
+                y[col] = calc_y(red[col], green[col], blue[col]);
+                pb[col] = calc_pb(red[col], green[col], blue[col]);
+                pr[col] = calc_pr(red[col], green[col], blue[col]);
+        }
 
+        return in_range;
 }
 
 /*********************************** calc_y ***********************************
@@ -164,16 +182,13 @@ void compress_yPbPr_apply(int col, int row, A2Methods_UArray2 array2b,
  * Return:
  *              Unscaled float representation of Y
  * Expects:
- *              r, g, b are in range 0 to 1
+ *              r, g, b are in range 0 to 1, as rgb_to_component_row checks
  * Notes:
- *              will CRE if expectations fail
+ *              none
  *
  *****************************************************************************/
 float calc_y(float r, float g, float b)
 {
-        assert(r >= RGB_UNSCALED_MIN && r <= RGB_UNSCALED_MAX);
-        assert(g >= RGB_UNSCALED_MIN && g <= RGB_UNSCALED_MAX);
-        assert(b >= RGB_UNSCALED_MIN && b <= RGB_UNSCALED_MAX);
         return 0.299 * r + 0.587 * g + 0.114 * b;
 }
 
@@ -188,16 +203,13 @@ float calc_y(float r, float g, float b)
  * Return:
  *              Unscaled float representation of Pr
  * Expects:
- *              r, g, b are in range 0 to 1
+ *              r, g, b are in range 0 to 1, as rgb_to_component_row checks
  * Notes:
- *              will CRE if expectations fail
+ *              none
  *
  *****************************************************************************/
 float calc_pr(float r, float g, float b)
 {
-        assert(r >= RGB_UNSCALED_MIN && r <= RGB_UNSCALED_MAX);
-        assert(g >= RGB_UNSCALED_MIN && g <= RGB_UNSCALED_MAX);
-        assert(b >= RGB_UNSCALED_MIN && b <= RGB_UNSCALED_MAX);
         return 0.5 * r - 0.418688 * g - 0.081312 * b;
 }
 
@@ -212,16 +224,13 @@ float calc_pr(float r, float g, float b)
  * Return:
  *              Unscaled float representation of Pb
  * Expects:
- *              r, g, b are in range 0 to 1
+ *              r, g, b are in range 0 to 1, as rgb_to_component_row checks
  * Notes:
- *              will CRE if expectations fail
+ *              none
  *
  *****************************************************************************/
 float calc_pb(float r, float g, float b)
 {
-        assert(r >= RGB_UNSCALED_MIN && r <= RGB_UNSCALED_MAX);
-        assert(g >= RGB_UNSCALED_MIN && g <= RGB_UNSCALED_MAX);
-        assert(b >= RGB_UNSCALED_MIN && b <= RGB_UNSCALED_MAX);
         return -0.168736 * r - 0.331264 * g + 0.5 * b;
 }
 
@@ -319,10 +328,33 @@ void decompress_yPbPr_apply(int col, int row, A2Methods_UArray2 array2b,
 
         /* Calculates and stores the rgb values */
         Pnm_rgb_float new_pixel = methods->at(rgb_pix, col, row);
-        new_pixel->red = calc_r(curr_pix->y, curr_pix->pb, curr_pix->pr);
-        new_pixel->green = calc_g(curr_pix->y, curr_pix->pb, curr_pix->pr);
-        new_pixel->blue = calc_bl(curr_pix->y, curr_pix->pb, curr_pix->pr);
+        component_to_rgb(curr_pix, new_pixel);
+
+}
+
+/*************************** component_to_rgb *********************************
+ *
+ * Converts one pixel from Y, Pb, Pr floats to unscaled rgb floats
+ *
+ * Inputs:
+ *              component_video pixel: the component video pixel to convert
+ *              Pnm_rgb_float result: where the unscaled rgb values are stored
+ * Return:
+ *              none - the rgb floats are stored in result
+ * Expects:
+ *              pixel and result are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void component_to_rgb(component_video pixel, Pnm_rgb_float result)
+{
+        assert(pixel != NULL);
+        assert(result != NULL);
 
+        result->red = calc_r(pixel->y, pixel->pb, pixel->pr);
+        result->green = calc_g(pixel->y, pixel->pb, pixel->pr);
+        result->blue = calc_bl(pixel->y, pixel->pb, pixel->pr);
 }
 
 /*********************************** calc_r **********************************
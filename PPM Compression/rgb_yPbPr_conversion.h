@@ -14,7 +14,14 @@
 /* CS40 Libraries */
 #include <pnm.h>
 
-extern A2Methods_UArray2 compress_yPbPr_conversion(Pnm_ppm image);
+/* Custom .h files */
+#include "compress_structs.h"
+#include "planar.h"
+
+extern planar_image compress_yPbPr_conversion(planar_image rgb);
 extern Pnm_ppm decompress_yPbPr_conversion(A2Methods_UArray2 component_pixels);
+extern void rgb_to_component_row(planar_image rgb, planar_image component, 
+                                 int row);
+extern void component_to_rgb(component_video pixel, Pnm_rgb_float result);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,215 @@
+/*
+ *      stream40.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Implementation for the stream40.h file. Functions in this file read
+ *      a ppm image two scanlines at a time and write the code word of each
+ *      2x2 block as soon as its pixels are read. The blocks of a row are
+ *      quantized by a kernel of block_rows.c, which gives the same values 
+ *      as the steps of compress40.c, so the output is the same bytes.
+ *      Decompression reads one row of code words and writes its two 
+ *      scanlines before reading the next
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/* CS40 Libraries */
+#include <pnm.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "stream40.h"
+#include "compress_structs.h"
+#include "read_and_write.h"
+#include "rgb_conversion.h"
+#include "rgb_yPbPr_conversion.h"
+#include "merge_blocks.h"
+#include "final_bitpack.h"
+#include "block_rows.h"
+
+/* The denominator of decompressed images */
+static const unsigned RGB_DENOMINATOR = 255;
+
+
+/**************************** stream_compress40 *******************************
+ *
+ * Compresses a ppm image and writes output to stdout, one row of 2x2 blocks
+ * at a time
+ *
+ * Inputs:
+ *              FILE *input: The ppm image to compress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL
+ * Notes:
+ *              will CRE if expectations fail
+ *              only two scanlines of the image are held in memory
+ *              an odd last column or row is trimmed, as compress40 does
+ *
+ *****************************************************************************/
+void stream_compress40(FILE *input)
+{
+        assert(input != NULL);
+
+        ppm_header header = read_ppm_header(input);
+
+        /* If width or height is odd, trim the last column or row */
+        unsigned width = header.width - header.width % 2;
+        unsigned height = header.height - header.height % 2;
+
+        /* The two scanlines holding the current row of blocks, read as
+           raw samples with one call and then turned into pixels */
+        size_t sample_bytes = ppm_sample_bytes(header);
+        unsigned char *samples = malloc(2 * sample_bytes + 1);
+        Pnm_rgb top = malloc(header.width * sizeof(struct Pnm_rgb));
+        Pnm_rgb bottom = malloc(header.width * sizeof(struct Pnm_rgb));
+        assert(samples != NULL && top != NULL && bottom != NULL);
+
+        /* The quantized values of the current row of blocks */
+        unsigned blocks = width / 2;
+        quantized_values quantized = malloc((blocks + 1) * 
+                                            sizeof(struct quantized_values));
+        unsigned char *codewords = malloc(blocks * CODEWORD_BYTES + 1);
+        block_row_planes planes = block_row_planes_new(blocks);
+        assert(quantized != NULL && codewords != NULL);
+
+        /* Print output header */
+        printf("COMP40 Compressed image format 2\n%u %u\n", width, height);
+
+        /* Compress each row of blocks as soon as it has been read */
+        for (unsigned row = 0; row < height; row += 2) {
+                read_ppm_samples(input, header, 2, samples);
+                samples_to_ppm_row(samples, header, top);
+                samples_to_ppm_row(samples + sample_bytes, header, bottom);
+                compress_block_row(top, bottom, blocks, header.denominator,
+                                   planes, quantized);
+                write_codeword_row(quantized, blocks, codewords, stdout);
+        }
+
+        free(samples);
+        free(top);
+        free(bottom);
+        free(quantized);
+        free(codewords);
+        block_row_planes_free(&planes);
+}
+
+/*************************** stream_decompress40 ******************************
+ *
+ * Decompresses a compressed file back to ppm file format, one row of code
+ * words at a time
+ *
+ * Inputs:
+ *              FILE *input: The file to decompress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL
+ * Notes:
+ *              will CRE if expectations fail
+ *              only two scanlines of the image are held in memory
+ *              rgb values are truncated to 0 to 1 and scaled by 255, instead
+ *                      of being rescaled by the min and max of the whole 
+ *                      image as decompress40 does
+ *
+ *****************************************************************************/
+void stream_decompress40(FILE *input)
+{
+        assert(input != NULL);
+
+        unsigned width, height;
+        read_compressed_header(input, &width, &height);
+        stream_decompress_rows(input, width, height);
+}
+
+/************************** stream_decompress_rows ****************************
+ *
+ * Decompresses the code words of a format 2 file, after its header, back to
+ * ppm file format, one row of code words at a time
+ *
+ * Inputs:
+ *              FILE *input: The file to decompress, just past its header
+ *              unsigned width: the width of the image in the header
+ *              unsigned height: the height of the image in the header
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL and holds every code word of the image
+ * Notes:
+ *              will CRE if expectations fail
+ *              also used by tiled_decompress40 for format 2 files
+ *
+ *****************************************************************************/
+void stream_decompress_rows(FILE *input, unsigned width, unsigned height)
+{
+        assert(input != NULL);
+
+        /* The two scanlines of the current row of blocks */
+        Pnm_rgb top = malloc(width * sizeof(struct Pnm_rgb));
+        Pnm_rgb bottom = malloc(width * sizeof(struct Pnm_rgb));
+        unsigned char *codewords = malloc(width / 2 * CODEWORD_BYTES + 1);
+        assert(top != NULL && bottom != NULL && codewords != NULL);
+
+        write_ppm_header(width, height, RGB_DENOMINATOR);
+
+        /* Write out each row of blocks as soon as its code words are read */
+        for (unsigned row = 0; row < height; row += 2) {
+                read_codeword_row(input, width / 2, codewords);
+                for (unsigned col = 0; col < width; col += 2) {
+                        decompress_block(load_codeword(&codewords[col / 2 *
+                                                       CODEWORD_BYTES]),
+                                         &top[col], &bottom[col]);
+                }
+                write_ppm_row(top, width);
+                write_ppm_row(bottom, width);
+        }
+
+        free(top);
+        free(bottom);
+        free(codewords);
+}
+
+/**************************** decompress_block ********************************
+ *
+ * Unpacks one code word and stores the scaled rgb values of its 2x2 block,
+ * for stream_decompress40 and parallel_decompress40
+ *
+ * Inputs:
+ *              uint64_t word: the code word of the block
+ *              Pnm_rgb top: where the top left pixel of the block is stored,
+ *                           followed by the top right pixel
+ *              Pnm_rgb bottom: where the bottom left pixel of the block is
+ *                              stored, followed by the bottom right pixel
+ * Return:
+ *              none - the pixels are stored in top and bottom
+ * Expects:
+ *              top and bottom are not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void decompress_block(uint64_t word, Pnm_rgb top, Pnm_rgb bottom)
+{
+        assert(top != NULL && bottom != NULL);
+
+        /* Unpack the code word into the component video of each pixel */
+        struct quantized_values quantized;
+        struct component_video block[4];
+        unpack_fields(word, &quantized);
+        split_block(&quantized, &block[0], &block[1], &block[2], &block[3]);
+
+        /* Convert each pixel to unscaled floats and then scaled integers */
+        Pnm_rgb pixels[4] = {&top[0], &top[1], &bottom[0], &bottom[1]};
+        for (int i = 0; i < 4; i++) {
+                struct Pnm_rgb_float rgb;
+                component_to_rgb(&block[i], &rgb);
+                float_to_rgb(&rgb, pixels[i]);
+        }
+}
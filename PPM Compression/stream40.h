@@ -0,0 +1,28 @@
+/*
+ *      stream40.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Interface for the stream40.c file. Functions in this file compress a
+ *      ppm image and decompress a compressed file one row of 2x2 blocks at a
+ *      time, without the full size arrays that compress40.c passes between
+ *      steps
+ */
+
+#ifndef STREAM40_INCLUDED
+#define STREAM40_INCLUDED
+
+/* Standard C Libraries */
+#include <stdio.h>
+#include <stdint.h>
+
+/* CS40 Libraries */
+#include <pnm.h>
+
+extern void stream_compress40(FILE *input);
+extern void stream_decompress40(FILE *input);
+extern void stream_decompress_rows(FILE *input, unsigned width, 
+                                   unsigned height);
+extern void decompress_block(uint64_t word, Pnm_rgb top, Pnm_rgb bottom);
+
+#endif
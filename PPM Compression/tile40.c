@@ -0,0 +1,675 @@
+/*
+ *      tile40.c
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Implementation for the tile40.h file. A COMP40 format 3 file starts
+ *      with the header
+ *              COMP40 Compressed image format 3
+ *              width height tile
+ *      where tile is the even number of pixels across and down a tile. The
+ *      image is split into tiles from its top left corner; the tiles of the
+ *      last column and row are cut short. Next comes the index, the offset
+ *      of every tile in rows of tiles from the top, each eight bytes
+ *      big-endian, counted from the first byte after the index. Then the
+ *      tiles, each holding its code words one row of blocks at a time.
+ *      A format 2 file is read as if each row of blocks were a tile, with
+ *      offsets worked out from the size of a code word. Decompressing a
+ *      rectangle only reads the code words of the blocks it overlaps, and
+ *      skips the rest with fseeko, or by reading past them from a pipe
+ */
+
+/* Standard C Libraries */
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+/* CS40 Libraries */
+#include <pnm.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
+/* Custom .h files */
+#include "tile40.h"
+#include "compress_structs.h"
+#include "read_and_write.h"
+#include "final_bitpack.h"
+#include "block_rows.h"
+#include "stream40.h"
+
+/* Blocks across and down a tile that tiled_compress40 writes */
+static const unsigned TILE_BLOCKS = 32;
+
+/* Bytes of an offset in the index */
+static const unsigned INDEX_ENTRY_BYTES = 8;
+
+/* The denominator of decompressed images */
+static const unsigned RGB_DENOMINATOR = 255;
+
+/* Bytes read at a time to skip code words of a pipe */
+#define SKIP_BYTES 4096
+
+/**********struct tile_layout********
+ * About: This struct holds the size of a compressed image, the size of its
+ *        tiles in blocks, and the offset of each tile from the first code
+ *        word, in rows of tiles from the top
+************************/
+struct tile_layout {
+        unsigned format;
+        unsigned width, height;
+        unsigned blocks, rows;
+        unsigned tile_blocks, tile_rows;
+        unsigned tiles_across, tiles_down;
+        uint64_t *offsets;
+};
+
+/**********struct region********
+ * About: This struct holds a rectangle of an image, in pixels
+************************/
+struct region {
+        unsigned x, y, width, height;
+};
+
+/**********struct codeword_reader********
+ * About: This struct holds a compressed file, where its first code word is,
+ *        and how many bytes of code words have been read or skipped
+************************/
+struct codeword_reader {
+        FILE *input;
+        bool seekable;
+        off_t start;
+        uint64_t position;
+};
+
+/**********struct band********
+ * About: This struct holds the blocks of a band of tiles that a region
+ *        overlaps, as pixels with scanline pixels to a row, and room for
+ *        the code words of one row of those blocks
+************************/
+struct band {
+        unsigned first_col, end_col;
+        unsigned first_row, end_row;
+        Pnm_rgb pixels;
+        size_t scanline;
+        unsigned char *codewords;
+};
+
+/* The rectangle chosen with use_region */
+static struct region region;
+static bool region_chosen = false;
+
+void lay_out_tiles(struct tile_layout *layout, unsigned tile_blocks,
+                   unsigned tile_rows);
+unsigned tile_width(const struct tile_layout *layout, unsigned tile_col);
+unsigned tile_height(const struct tile_layout *layout, unsigned tile_row);
+void read_tiled_header(FILE *input, struct tile_layout *layout);
+void store_offset(uint64_t offset, unsigned char *bytes);
+uint64_t load_offset(const unsigned char *bytes);
+void decompress_region(FILE *input, const struct tile_layout *layout,
+                       struct region area);
+void decompress_tile(struct codeword_reader *reader,
+                     const struct tile_layout *layout, unsigned tile_col,
+                     unsigned tile_row, struct band *band);
+void read_codewords_at(struct codeword_reader *reader, uint64_t offset,
+                       unsigned count, unsigned char *codewords);
+
+
+/******************************** use_region **********************************
+ *
+ * Sets the rectangle of the image that tiled_decompress40 decompresses
+ *
+ * Inputs:
+ *              unsigned x: the column of the left edge, in pixels
+ *              unsigned y: the row of the top edge, in pixels
+ *              unsigned width: the width of the rectangle, in pixels
+ *              unsigned height: the height of the rectangle, in pixels
+ * Return:
+ *              none
+ * Expects:
+ *              width and height to be more than 0
+ * Notes:
+ *              will CRE if expectations fail
+ *              tiled_decompress40 checks that the rectangle is in the image
+ *
+ *****************************************************************************/
+void use_region(unsigned x, unsigned y, unsigned width, unsigned height)
+{
+        assert(width > 0 && height > 0);
+
+        region.x = x;
+        region.y = y;
+        region.width = width;
+        region.height = height;
+        region_chosen = true;
+}
+
+/***************************** tiled_compress40 *******************************
+ *
+ * Compresses a ppm image to COMP40 format 3 and writes output to stdout
+ *
+ * Inputs:
+ *              FILE *input: The ppm image to compress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL
+ * Notes:
+ *              will CRE if expectations fail
+ *              the code words are the ones stream_compress40 gives, in tile
+ *                      order; one band of tiles is held in memory at a time
+ *              an odd last column or row is trimmed, as compress40 does
+ *
+ *****************************************************************************/
+void tiled_compress40(FILE *input)
+{
+        assert(input != NULL);
+
+        ppm_header header = read_ppm_header(input);
+
+        /* Every code word has the same size, so the index is known now */
+        struct tile_layout layout;
+        layout.format = 3;
+        layout.width = header.width - header.width % 2;
+        layout.height = header.height - header.height % 2;
+        lay_out_tiles(&layout, TILE_BLOCKS, TILE_BLOCKS);
+
+        size_t tiles = (size_t)layout.tiles_across * layout.tiles_down;
+        unsigned char *index = malloc(tiles * INDEX_ENTRY_BYTES + 1);
+        assert(index != NULL);
+        for (size_t i = 0; i < tiles; i++) {
+                store_offset(layout.offsets[i], &index[i * INDEX_ENTRY_BYTES]);
+        }
+
+        printf("COMP40 Compressed image format 3\n%u %u %u\n", layout.width,
+               layout.height, TILE_BLOCKS * 2);
+        fwrite(index, INDEX_ENTRY_BYTES, tiles, stdout);
+
+        /* The two scanlines, read as raw samples with one call, the
+           quantized values of a row of blocks, and the code words of a
+           band of tiles in the order they are written */
+        unsigned blocks = layout.blocks;
+        size_t sample_bytes = ppm_sample_bytes(header);
+        unsigned char *samples = malloc(2 * sample_bytes + 1);
+        Pnm_rgb top = malloc(header.width * sizeof(struct Pnm_rgb) + 1);
+        Pnm_rgb bottom = malloc(header.width * sizeof(struct Pnm_rgb) + 1);
+        quantized_values quantized = malloc((blocks + 1) *
+                                            sizeof(struct quantized_values));
+        unsigned char *band = malloc((size_t)TILE_BLOCKS * blocks *
+                                     CODEWORD_BYTES + 1);
+        assert(samples != NULL && top != NULL && bottom != NULL &&
+               quantized != NULL && band != NULL);
+        block_row_planes planes = block_row_planes_new(blocks);
+
+        for (unsigned tile_row = 0; tile_row < layout.tiles_down;
+             tile_row++) {
+                unsigned band_rows = tile_height(&layout, tile_row);
+                for (unsigned row = 0; row < band_rows; row++) {
+                        read_ppm_samples(input, header, 2, samples);
+                        samples_to_ppm_row(samples, header, top);
+                        samples_to_ppm_row(samples + sample_bytes, header,
+                                           bottom);
+                        compress_block_row(top, bottom, blocks,
+                                           header.denominator, planes,
+                                           quantized);
+
+                        /* Every tile left of a block is a full tile */
+                        for (unsigned i = 0; i < blocks; i++) {
+                                unsigned tile_col = i / TILE_BLOCKS;
+                                size_t word = (size_t)tile_col *
+                                              TILE_BLOCKS * band_rows +
+                                              row * tile_width(&layout,
+                                                               tile_col) +
+                                              i % TILE_BLOCKS;
+                                store_codeword(pack_fields(&quantized[i]),
+                                               &band[word * CODEWORD_BYTES]);
+                        }
+                }
+                fwrite(band, CODEWORD_BYTES, (size_t)blocks * band_rows,
+                       stdout);
+        }
+
+        free(layout.offsets);
+        free(index);
+        free(samples);
+        free(top);
+        free(bottom);
+        free(quantized);
+        free(band);
+        block_row_planes_free(&planes);
+}
+
+/**************************** tiled_decompress40 ******************************
+ *
+ * Decompresses a format 2 or format 3 compressed file back to ppm file
+ * format, or only the rectangle chosen with use_region
+ *
+ * Inputs:
+ *              FILE *input: The file to decompress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input is not NULL
+ * Notes:
+ *              will CRE if expectations fail
+ *              a rectangle that is not inside the image is reported on
+ *                      stderr and exits with 1, before anything is written
+ *              the pixels are the ones stream_decompress40 gives; a whole
+ *                      format 2 file is decompressed by it
+ *
+ *****************************************************************************/
+void tiled_decompress40(FILE *input)
+{
+        assert(input != NULL);
+
+        struct tile_layout layout;
+        read_tiled_header(input, &layout);
+
+        if (!region_chosen && layout.format == 2) {
+                stream_decompress_rows(input, layout.width, layout.height);
+        } else if (!region_chosen) {
+                struct region whole = {0, 0, layout.width, layout.height};
+                decompress_region(input, &layout, whole);
+        } else {
+                if ((uint64_t)region.x + region.width > layout.width ||
+                    (uint64_t)region.y + region.height > layout.height) {
+                        fprintf(stderr, "region %u,%u,%u,%u is outside the "
+                                "%ux%u image\n", region.x, region.y,
+                                region.width, region.height, layout.width,
+                                layout.height);
+                        free(layout.offsets);
+                        exit(1);
+                }
+                decompress_region(input, &layout, region);
+        }
+
+        free(layout.offsets);
+}
+
+/****************************** lay_out_tiles *********************************
+ *
+ * Splits an image into tiles and works out the offset of each tile when
+ * every code word takes CODEWORD_BYTES bytes
+ *
+ * Inputs:
+ *              struct tile_layout *layout: the layout, with its format,
+ *                                          width and height set
+ *              unsigned tile_blocks: the blocks across a full tile
+ *              unsigned tile_rows: the rows of blocks down a full tile
+ * Return:
+ *              none - the rest of layout is set
+ * Expects:
+ *              layout not to be null and tile_blocks and tile_rows to be
+ *              more than 0
+ * Notes:
+ *              will CRE if expectations fail
+ *              layout->offsets is malloced and must be freed
+ *
+ *****************************************************************************/
+void lay_out_tiles(struct tile_layout *layout, unsigned tile_blocks,
+                   unsigned tile_rows)
+{
+        assert(layout != NULL);
+        assert(tile_blocks > 0 && tile_rows > 0);
+
+        layout->blocks = layout->width / 2;
+        layout->rows = layout->height / 2;
+        layout->tile_blocks = tile_blocks;
+        layout->tile_rows = tile_rows;
+        layout->tiles_across = layout->blocks / tile_blocks +
+                               (layout->blocks % tile_blocks != 0);
+        layout->tiles_down = layout->rows / tile_rows +
+                             (layout->rows % tile_rows != 0);
+
+        size_t tiles = (size_t)layout->tiles_across * layout->tiles_down;
+        layout->offsets = malloc(tiles * sizeof(uint64_t) + 1);
+        assert(layout->offsets != NULL);
+
+        uint64_t offset = 0;
+        for (unsigned row = 0; row < layout->tiles_down; row++) {
+                for (unsigned col = 0; col < layout->tiles_across; col++) {
+                        layout->offsets[(size_t)row * layout->tiles_across +
+                                        col] = offset;
+                        offset += (uint64_t)tile_width(layout, col) *
+                                  tile_height(layout, row) * CODEWORD_BYTES;
+                }
+        }
+}
+
+/******************************* tile_width ***********************************
+ *
+ * Gives the number of blocks across the tiles of a column of tiles
+ *
+ * Inputs:
+ *              const struct tile_layout *layout: the layout of the image
+ *              unsigned tile_col: the column of tiles, from the left
+ * Return:
+ *              the blocks across a full tile, or fewer for the last column
+ * Expects:
+ *              tile_col to be less than layout->tiles_across
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+unsigned tile_width(const struct tile_layout *layout, unsigned tile_col)
+{
+        unsigned left = tile_col * layout->tile_blocks;
+        if (layout->blocks - left < layout->tile_blocks) {
+                return layout->blocks - left;
+        }
+
+        return layout->tile_blocks;
+}
+
+/******************************* tile_height **********************************
+ *
+ * Gives the number of rows of blocks down the tiles of a row of tiles
+ *
+ * Inputs:
+ *              const struct tile_layout *layout: the layout of the image
+ *              unsigned tile_row: the row of tiles, from the top
+ * Return:
+ *              the rows down a full tile, or fewer for the last row
+ * Expects:
+ *              tile_row to be less than layout->tiles_down
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+unsigned tile_height(const struct tile_layout *layout, unsigned tile_row)
+{
+        unsigned top = tile_row * layout->tile_rows;
+        if (layout->rows - top < layout->tile_rows) {
+                return layout->rows - top;
+        }
+
+        return layout->tile_rows;
+}
+
+/***************************** read_tiled_header ******************************
+ *
+ * Reads the header of a format 2 or format 3 compressed file, and the index
+ * of a format 3 file, up to its first code word
+ *
+ * Inputs:
+ *              FILE *input: pointer to input stream to read the header from
+ *              struct tile_layout *layout: where the layout of the image is
+ *                                          stored
+ * Return:
+ *              none - the layout is stored in layout; a format 2 file has
+ *              one tile for each row of blocks
+ * Expects:
+ *              input and layout not to be null and the stream to start with
+ *              a COMP40 format 2 or format 3 header
+ * Notes:
+ *              will CRE if expectations fail
+ *              layout->offsets is malloced and must be freed
+ *
+ *****************************************************************************/
+void read_tiled_header(FILE *input, struct tile_layout *layout)
+{
+        assert(input != NULL && layout != NULL);
+
+        int read = fscanf(input, "COMP40 Compressed image format %u\n%u %u",
+                          &layout->format, &layout->width, &layout->height);
+        assert(read == 3);
+        assert(layout->format == 2 || layout->format == 3);
+
+        if (layout->format == 2) {
+                int c = getc(input);
+                assert(c == '\n');
+                unsigned blocks = layout->width / 2;
+                lay_out_tiles(layout, blocks > 0 ? blocks : 1, 1);
+                return;
+        }
+
+        unsigned tile;
+        read = fscanf(input, "%u", &tile);
+        assert(read == 1 && tile >= 2 && tile % 2 == 0);
+        int c = getc(input);
+        assert(c == '\n');
+        lay_out_tiles(layout, tile / 2, tile / 2);
+
+        /* Take the offsets of the index over the ones worked out */
+        size_t tiles = (size_t)layout->tiles_across * layout->tiles_down;
+        unsigned char *index = malloc(tiles * INDEX_ENTRY_BYTES + 1);
+        assert(index != NULL);
+        size_t entries = fread(index, INDEX_ENTRY_BYTES, tiles, input);
+        assert(entries == tiles);
+        for (size_t i = 0; i < tiles; i++) {
+                layout->offsets[i] = load_offset(&index[i *
+                                                       INDEX_ENTRY_BYTES]);
+        }
+        free(index);
+}
+
+/******************************** store_offset ********************************
+ *
+ * Stores an offset of the index in memory in big-endian order
+ *
+ * Inputs:
+ *              uint64_t offset: the offset to store
+ *              unsigned char *bytes: where the eight bytes are stored
+ * Return:
+ *              none - the offset is stored in bytes
+ * Expects:
+ *              bytes is not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void store_offset(uint64_t offset, unsigned char *bytes)
+{
+        assert(bytes != NULL);
+
+        store_codeword(offset >> 32, bytes);
+        store_codeword(offset & 0xffffffff, bytes + CODEWORD_BYTES);
+}
+
+/******************************** load_offset *********************************
+ *
+ * Gives an offset of the index stored in memory in big-endian order
+ *
+ * Inputs:
+ *              const unsigned char *bytes: the eight bytes of the offset
+ * Return:
+ *              the offset
+ * Expects:
+ *              bytes is not null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+uint64_t load_offset(const unsigned char *bytes)
+{
+        assert(bytes != NULL);
+
+        return load_codeword(bytes) << 32 |
+               load_codeword(bytes + CODEWORD_BYTES);
+}
+
+/***************************** decompress_region ******************************
+ *
+ * tiled_decompress40 helper function - decompresses a rectangle of the image
+ * one band of tiles at a time and writes it as a ppm image
+ *
+ * Inputs:
+ *              FILE *input: The file to decompress, just past its header
+ *                           and index
+ *              const struct tile_layout *layout: the layout of the image
+ *              struct region area: the rectangle to decompress
+ * Return:
+ *              none - all output is printed to stdout
+ * Expects:
+ *              input and layout not to be null, and area to be inside the
+ *              image
+ * Notes:
+ *              will CRE if expectations fail
+ *              the blocks the rectangle overlaps in one band of tiles are
+ *                      held in memory at a time
+ *
+ *****************************************************************************/
+void decompress_region(FILE *input, const struct tile_layout *layout,
+                       struct region area)
+{
+        assert(input != NULL && layout != NULL);
+
+        /* The blocks the rectangle overlaps */
+        struct band band;
+        band.first_col = area.x / 2;
+        band.end_col = (area.x + area.width + 1) / 2;
+        unsigned first_row = area.y / 2;
+        unsigned end_row = (area.y + area.height + 1) / 2;
+
+        unsigned span = band.end_col - band.first_col;
+        band.scanline = (size_t)span * 2;
+        band.pixels = malloc(2 * layout->tile_rows * band.scanline *
+                             sizeof(struct Pnm_rgb) + 1);
+        band.codewords = malloc(span * CODEWORD_BYTES + 1);
+        assert(band.pixels != NULL && band.codewords != NULL);
+
+        /* Skip code words by seeking if the file can be, or else reading */
+        struct codeword_reader reader = {input, false, ftello(input), 0};
+        reader.seekable = reader.start >= 0 &&
+                          lseek(fileno(input), 0, SEEK_CUR) >= 0;
+
+        write_ppm_header(area.width, area.height, RGB_DENOMINATOR);
+
+        for (unsigned tile_row = first_row / layout->tile_rows;
+             tile_row * layout->tile_rows < end_row; tile_row++) {
+                unsigned top = tile_row * layout->tile_rows;
+                band.first_row = top > first_row ? top : first_row;
+                band.end_row = top + tile_height(layout, tile_row);
+                if (band.end_row > end_row) {
+                        band.end_row = end_row;
+                }
+
+                for (unsigned tile_col = band.first_col / layout->tile_blocks;
+                     tile_col * layout->tile_blocks < band.end_col;
+                     tile_col++) {
+                        decompress_tile(&reader, layout, tile_col, tile_row,
+                                        &band);
+                }
+
+                /* Write the scanlines of the band inside the rectangle */
+                for (unsigned y = band.first_row * 2; y < band.end_row * 2;
+                     y++) {
+                        if (y < area.y || y >= area.y + area.height) {
+                                continue;
+                        }
+                        size_t line = y - band.first_row * 2;
+                        write_ppm_row(&band.pixels[line * band.scanline +
+                                                   area.x -
+                                                   band.first_col * 2],
+                                      area.width);
+                }
+        }
+
+        free(band.pixels);
+        free(band.codewords);
+}
+
+/****************************** decompress_tile *******************************
+ *
+ * decompress_region helper function - decompresses the blocks of one tile
+ * that are in a band, and stores their pixels in the band
+ *
+ * Inputs:
+ *              struct codeword_reader *reader: the file to read from
+ *              const struct tile_layout *layout: the layout of the image
+ *              unsigned tile_col: the column of the tile, from the left
+ *              unsigned tile_row: the row of the tile, from the top
+ *              struct band *band: the blocks to decompress and where their
+ *                                 pixels are stored
+ * Return:
+ *              none - the pixels are stored in band->pixels
+ * Expects:
+ *              reader, layout and band not to be null, and the band to be
+ *              inside the row of tiles
+ * Notes:
+ *              will CRE if expectations fail
+ *              reads the code words of each row of blocks of the tile that
+ *                      are in the band with one fread
+ *
+ *****************************************************************************/
+void decompress_tile(struct codeword_reader *reader,
+                     const struct tile_layout *layout, unsigned tile_col,
+                     unsigned tile_row, struct band *band)
+{
+        assert(reader != NULL && layout != NULL && band != NULL);
+
+        unsigned left = tile_col * layout->tile_blocks;
+        unsigned top = tile_row * layout->tile_rows;
+        unsigned width = tile_width(layout, tile_col);
+        unsigned from = left > band->first_col ? left : band->first_col;
+        unsigned to = left + width < band->end_col ? left + width
+                                                   : band->end_col;
+        uint64_t tile = layout->offsets[(size_t)tile_row *
+                                        layout->tiles_across + tile_col];
+
+        for (unsigned row = band->first_row; row < band->end_row; row++) {
+                uint64_t offset = tile + ((uint64_t)(row - top) * width +
+                                          from - left) * CODEWORD_BYTES;
+                read_codewords_at(reader, offset, to - from, band->codewords);
+
+                size_t line = (size_t)(row - band->first_row) * 2;
+                Pnm_rgb top_pixels = &band->pixels[line * band->scanline +
+                                                   (from - band->first_col) *
+                                                   2];
+                Pnm_rgb bottom_pixels = top_pixels + band->scanline;
+                for (unsigned i = 0; i < to - from; i++) {
+                        uint64_t word = load_codeword(&band->codewords[i *
+                                                      CODEWORD_BYTES]);
+                        decompress_block(word, &top_pixels[i * 2],
+                                         &bottom_pixels[i * 2]);
+                }
+        }
+}
+
+/***************************** read_codewords_at ******************************
+ *
+ * decompress_tile helper function - reads code words from an offset after
+ * the first code word of a compressed file
+ *
+ * Inputs:
+ *              struct codeword_reader *reader: the file to read from
+ *              uint64_t offset: the offset of the first code word to read
+ *              unsigned count: the number of code words to read
+ *              unsigned char *codewords: room for count code words
+ * Return:
+ *              none - the bytes of the code words are stored in codewords
+ * Expects:
+ *              reader and codewords not to be null, the file to hold the
+ *              code words, and offset not to be before the code words
+ *              already read when the file cannot be seeked
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+void read_codewords_at(struct codeword_reader *reader, uint64_t offset,
+                       unsigned count, unsigned char *codewords)
+{
+        assert(reader != NULL && codewords != NULL);
+
+        if (offset != reader->position && reader->seekable) {
+                int failed = fseeko(reader->input, reader->start +
+                                    (off_t)offset, SEEK_SET);
+                assert(!failed);
+        } else if (offset != reader->position) {
+                assert(offset > reader->position);
+                unsigned char skipped[SKIP_BYTES];
+                uint64_t left = offset - reader->position;
+                while (left > 0) {
+                        size_t bytes = left < SKIP_BYTES ? left : SKIP_BYTES;
+                        size_t read = fread(skipped, 1, bytes, reader->input);
+                        assert(read == bytes);
+                        left -= bytes;
+                }
+        }
+
+        read_codeword_row(reader->input, count, codewords);
+        reader->position = offset + (uint64_t)count * CODEWORD_BYTES;
+}
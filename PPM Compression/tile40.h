@@ -0,0 +1,23 @@
+/*
+ *      tile40.h
+ *      by Cansu Birsen (cbirse01), Ethan Goldman (gethan01)
+ *      PPM Compression
+ *
+ *      Interface for the tile40.c file. Functions in this file compress a
+ *      ppm image to COMP40 format 3, which keeps the code words in square
+ *      tiles and starts with the offset of each tile, and decompress a
+ *      format 2 or format 3 file, or only a rectangle of its image
+ */
+
+#ifndef TILE40_INCLUDED
+#define TILE40_INCLUDED
+
+/* Standard C Libraries */
+#include <stdio.h>
+
+extern void use_region(unsigned x, unsigned y, unsigned width,
+                       unsigned height);
+extern void tiled_compress40(FILE *input);
+extern void tiled_decompress40(FILE *input);
+
+#endif
@@ -8,14 +8,47 @@
  *      .um extension to read and implement instructions using the operations
  *      module. If the file cannot be opened properly or not supplied, returns
  *      with EXIT_FAILURE.
+ *
+ *      Usage: um [--mem seq|flat|arena] file.um
+ *             um --bench file.um
+ *
+ *      --mem chooses how segmented memory is stored, flat being the default.
+ *      --bench runs the program once with every memory backend and reports
+ *      the CPU time of each run on stderr.
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Hanson Libraries */
+#include <assert.h>
+
 #include "operations.h"
 
 FILE *open_or_die(int argc, char *argv[]);
+void benchmark_backends(FILE *fp);
 
 int main(int argc, char *argv[]) {
+        Mem_backend backend = MEM_FLAT;
+        bool bench = false;
+
+        /* flags before the file name choose the memory backend */
+        while (argc > 2 && strncmp(argv[1], "--", 2) == 0) {
+                if (strcmp(argv[1], "--bench") == 0) {
+                        bench = true;
+                } else if (strcmp(argv[1], "--mem") == 0 && argc > 3 &&
+                           memory_backend_find(argv[2], &backend)) {
+                        argc--;
+                        argv++;
+                } else {
+                        fprintf(stderr, "Unknown option %s.\n", argv[1]);
+                        return EXIT_FAILURE;
+                }
+                argc--;
+                argv++;
+        }
+
         /* open input file */
         FILE *fp = open_or_die(argc, argv);
         if (fp == NULL) {
@@ -23,7 +56,11 @@ int main(int argc, char *argv[]) {
         }
 
         /* Calls operations module to implement the instructions */
-        initiate_program(fp);
+        if (bench) {
+                benchmark_backends(fp);
+        } else {
+                initiate_program(fp, backend);
+        }
 
         fclose(fp);
 
@@ -34,25 +71,60 @@ int main(int argc, char *argv[]) {
 /**********open_or_die********
  *
  * About: checks if the program is started with the correct number of
- *        arguments. Opens the file either from argv or accept content from 
+ *        arguments. Opens the file either from argv or accept content from
  *        stdin.
  * Inputs:
  *      int argc: number of given arguments to start the program
  *      char *argv: an array that stores the arguments
  * Expects:
- *      If the given arguments do not equal 1 or 2, throws CRE 
- *      If the file cannot be opened, throws CRE 
+ *      If the given arguments do not equal 1 or 2, throws CRE
+ *      If the file cannot be opened, throws CRE
  *
  ************************/
-FILE *open_or_die(int argc, char *argv[]) {   
+FILE *open_or_die(int argc, char *argv[]) {
         /* check if correct number of arguments is supplied */
         if (argc != 2) {
                 fprintf(stderr, "Incorrect number of arguments.\n");
                 return NULL;
         }
 
-        FILE *fp; 
+        FILE *fp;
         fp = fopen(argv[1], "r");
-        
+
         return fp;
-}
\ No newline at end of file
+}
+
+/**********benchmark_backends********
+ *
+ * About: runs the program in fp once with each memory backend and prints
+ *        the CPU time each run took to stderr. The program and stdin are
+ *        rewound before each run, so input must be redirected from a file
+ *        for every run to see it.
+ * Inputs:
+ *      FILE *fp: open um file
+ * Expects:
+ *      fp to not be null, throws CRE otherwise
+ *
+ ************************/
+void benchmark_backends(FILE *fp) {
+        assert(fp != NULL);
+
+        double times[MEM_NUM_BACKENDS];
+        for (int i = 0; i < MEM_NUM_BACKENDS; i++) {
+                rewind(fp);
+                rewind(stdin);
+
+                clock_t start = clock();
+                initiate_program(fp, (Mem_backend)i);
+                fflush(stdout);
+                times[i] = (double)(clock() - start) / CLOCKS_PER_SEC;
+        }
+
+        /* times are relative to the original seq backend */
+        fprintf(stderr, "%-8s %10s %10s\n", "backend", "seconds", "speedup");
+        for (int i = 0; i < MEM_NUM_BACKENDS; i++) {
+                fprintf(stderr, "%-8s %10.3f %9.2fx\n",
+                        memory_backend_name((Mem_backend)i), times[i],
+                        times[i] > 0 ? times[MEM_SEQ] / times[i] : 0.0);
+        }
+}
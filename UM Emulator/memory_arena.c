@@ -0,0 +1,425 @@
+/*
+ *      memory_arena.c
+ *      by Cansu Birsen (cbirse01), Ayse Idil Kolabas (akolab01)
+ *      November 12, 2023
+ *      UM Emulator
+ *
+ *      Arena memory backend. The segment table is the same growable array of
+ *      pointers and lengths as the flat backend, but small segments are
+ *      carved out of large chunks instead of being malloc'd one by one. An
+ *      unmapped small segment goes on a free list for its size and is handed
+ *      out again by the next map of that size, which is the common pattern
+ *      of UM programs that map and unmap short-lived segments. Segments too
+ *      large for a free list are malloc'd directly. Chunks are only returned
+ *      when the memory is freed.
+ */
+
+
+/* Hanson Libraries */
+#include <assert.h>
+#include <mem.h>
+#include <string.h>
+
+/* Custom .h files */
+#include "memory_backend.h"
+
+/* Number of segment slots memory starts with */
+#define HINT 1024
+
+/* Number of words in each arena chunk */
+#define CHUNK_WORDS (1 << 20)
+
+/* Segments of up to this many words come from the arena */
+#define MAX_SMALL 1024
+
+/* memory as seen by this backend. free_lists[n] holds freed blocks of
+ * 2 * n words, linked through a pointer stored in their first words
+ */
+typedef struct Mem_arena {
+        struct Mem_T base;
+        uint32_t capacity;
+        uint32_t *free_ids;
+        uint32_t num_free;
+        uint32_t *bump;
+        uint32_t *chunk_end;
+        uint32_t **chunks;
+        int num_chunks;
+        uint32_t *free_lists[MAX_SMALL / 2 + 1];
+} *Mem_arena;
+
+/******************************** block_words *********************************
+ *
+ * Returns how many words the arena gives a segment of the given length.
+ * Sizes are rounded up to an even number of words, and at least two, so
+ * every block is pointer aligned and can hold a free list link.
+ *
+ * Inputs:
+ *              uint32_t length: number of words in the segment
+ * Return:
+ *              number of words in its block
+ * Expects:
+ *              none
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static inline uint32_t block_words(uint32_t length)
+{
+        return length < 2 ? 2 : (length + 1) & ~(uint32_t)1;
+}
+
+/******************************** arena_alloc *********************************
+ *
+ * Returns a block for a segment of the given length. Small blocks come from
+ * the free list for their size, or else from the current chunk, and large
+ * blocks come from malloc.
+ *
+ * Inputs:
+ *              Mem_arena mem: memory owning the arena
+ *              uint32_t length: number of words in the segment
+ * Return:
+ *              the block, its contents undefined
+ * Expects:
+ *              allocations to succeed
+ * Notes:
+ *              will CRE if expectation fails
+ *
+ *****************************************************************************/
+static uint32_t *arena_alloc(Mem_arena mem, uint32_t length)
+{
+        uint32_t words = block_words(length);
+
+        if (words > MAX_SMALL) {
+                uint32_t *block = malloc(words * sizeof(uint32_t));
+                assert(block != NULL);
+                return block;
+        }
+
+        /* reuse a freed block of the same size */
+        uint32_t **list = &mem->free_lists[words / 2];
+        if (*list != NULL) {
+                uint32_t *block = *list;
+                memcpy(list, block, sizeof(uint32_t *));
+                return block;
+        }
+
+        /* start a new chunk when the current one cannot fit the block */
+        if (mem->bump == NULL || (uint32_t)(mem->chunk_end - mem->bump) <
+                                 words) {
+                uint32_t *chunk = malloc(CHUNK_WORDS * sizeof(uint32_t));
+                assert(chunk != NULL);
+                RESIZE(mem->chunks, (mem->num_chunks + 1) *
+                                    sizeof(uint32_t *));
+                assert(mem->chunks != NULL);
+                mem->chunks[mem->num_chunks++] = chunk;
+                mem->bump = chunk;
+                mem->chunk_end = chunk + CHUNK_WORDS;
+        }
+
+        uint32_t *block = mem->bump;
+        mem->bump += words;
+
+        return block;
+}
+
+/******************************** arena_release *******************************
+ *
+ * Gives back the block of a segment of the given length
+ *
+ * Inputs:
+ *              Mem_arena mem: memory owning the arena
+ *              uint32_t *block: block returned by arena_alloc
+ *              uint32_t length: length the block was allocated for
+ * Return:
+ *              none
+ * Expects:
+ *              block to be in use
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static void arena_release(Mem_arena mem, uint32_t *block, uint32_t length)
+{
+        uint32_t words = block_words(length);
+
+        if (words > MAX_SMALL) {
+                free(block);
+                return;
+        }
+
+        uint32_t **list = &mem->free_lists[words / 2];
+        memcpy(block, list, sizeof(uint32_t *));
+        *list = block;
+}
+
+/******************************** arena_new *********************************
+ *
+ * Creates arena memory with the program copied into segment 0
+ *
+ * Inputs:
+ *              uint32_t *program: 32-bit words representing the program
+ *              uint32_t length: number of words in program
+ * Return:
+ *              the new memory
+ * Expects:
+ *              allocations to succeed
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static Mem_T arena_new(uint32_t *program, uint32_t length)
+{
+        Mem_arena mem;
+        NEW0(mem);
+        assert(mem != NULL);
+        mem->base.vtable = &Mem_arena_backend;
+
+        mem->capacity = HINT;
+        mem->base.segments = malloc(HINT * sizeof(uint32_t *));
+        mem->base.lengths = malloc(HINT * sizeof(uint32_t));
+        mem->free_ids = malloc(HINT * sizeof(uint32_t));
+        assert(mem->base.segments != NULL && mem->base.lengths != NULL);
+        assert(mem->free_ids != NULL);
+
+        mem->base.segments[0] = arena_alloc(mem, length);
+        memcpy(mem->base.segments[0], program, length * sizeof(uint32_t));
+        mem->base.lengths[0] = length;
+        mem->base.num_segments = 1;
+
+        return &mem->base;
+}
+
+/******************************** arena_free *********************************
+ *
+ * Frees the large segments still mapped, every chunk and the memory
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by arena_new
+ * Return:
+ *              none
+ * Expects:
+ *              memory to not be null
+ * Notes:
+ *              small segments live in the chunks and are freed with them
+ *
+ *****************************************************************************/
+static void arena_free(Mem_T memory)
+{
+        Mem_arena mem = (Mem_arena)memory;
+
+        for (uint32_t i = 0; i < mem->base.num_segments; i++) {
+                if (mem->base.segments[i] != NULL &&
+                    block_words(mem->base.lengths[i]) > MAX_SMALL) {
+                        free(mem->base.segments[i]);
+                }
+        }
+        for (int i = 0; i < mem->num_chunks; i++) {
+                free(mem->chunks[i]);
+        }
+
+        free(mem->chunks);
+        free(mem->base.segments);
+        free(mem->base.lengths);
+        free(mem->free_ids);
+        FREE(mem);
+}
+
+/******************************** arena_word_at *******************************
+ *
+ * Returns a pointer to the word in the given offset of the segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by arena_new
+ *              uint32_t seg_id: id of a mapped segment
+ *              uint32_t offset: index of the word in the segment
+ * Return:
+ *              pointer to the word
+ * Expects:
+ *              segment to be mapped and offset to be in bounds
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectations fail. an unmapped
+ *              segment has length 0, so one check covers both
+ *
+ *****************************************************************************/
+static uint32_t *arena_word_at(Mem_T memory, uint32_t seg_id, uint32_t offset)
+{
+        Mem_arena mem = (Mem_arena)memory;
+
+        if (seg_id >= mem->base.num_segments ||
+            offset >= mem->base.lengths[seg_id]) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return &mem->base.segments[seg_id][offset];
+}
+
+/******************************** arena_mapped ********************************
+ *
+ * Returns whether the segment with the given id is mapped
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by arena_new
+ *              uint32_t seg_id: id of the segment
+ * Return:
+ *              true if the segment is mapped
+ * Expects:
+ *              none
+ * Notes:
+ *              ids past the end of memory are unmapped
+ *
+ *****************************************************************************/
+static bool arena_mapped(Mem_T memory, uint32_t seg_id)
+{
+        Mem_arena mem = (Mem_arena)memory;
+
+        return seg_id < mem->base.num_segments &&
+               mem->base.segments[seg_id] != NULL;
+}
+
+/******************************** arena_length ********************************
+ *
+ * Returns number of words within a segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by arena_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              the number of words in the segment
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static uint32_t arena_length(Mem_T memory, uint32_t seg_id)
+{
+        Mem_arena mem = (Mem_arena)memory;
+
+        if (!arena_mapped(memory, seg_id)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return mem->base.lengths[seg_id];
+}
+
+/******************************** arena_map *********************************
+ *
+ * Maps a zeroed segment at the most recently unmapped id, or at a new id at
+ * the end of memory. The segment table doubles when it is full.
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by arena_new
+ *              uint32_t num_words: number of words in the new segment
+ * Return:
+ *              id of the new segment
+ * Expects:
+ *              allocations to succeed
+ * Notes:
+ *              will CRE if expectation fails
+ *
+ *****************************************************************************/
+static uint32_t arena_map(Mem_T memory, uint32_t num_words)
+{
+        Mem_arena mem = (Mem_arena)memory;
+
+        uint32_t *new_seg = arena_alloc(mem, num_words);
+        memset(new_seg, 0, num_words * sizeof(uint32_t));
+
+        uint32_t segment_id;
+        if (mem->num_free > 0) {
+                segment_id = mem->free_ids[--mem->num_free];
+        } else {
+                if (mem->base.num_segments == mem->capacity) {
+                        mem->capacity *= 2;
+                        RESIZE(mem->base.segments,
+                               mem->capacity * sizeof(uint32_t *));
+                        RESIZE(mem->base.lengths,
+                               mem->capacity * sizeof(uint32_t));
+                        RESIZE(mem->free_ids,
+                               mem->capacity * sizeof(uint32_t));
+                        assert(mem->base.segments != NULL);
+                        assert(mem->base.lengths != NULL);
+                        assert(mem->free_ids != NULL);
+                }
+                segment_id = mem->base.num_segments++;
+        }
+
+        mem->base.segments[segment_id] = new_seg;
+        mem->base.lengths[segment_id] = num_words;
+
+        return segment_id;
+}
+
+/******************************** arena_unmap *********************************
+ *
+ * Releases the block of the segment and pushes its id on the free id stack
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by arena_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              none
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static void arena_unmap(Mem_T memory, uint32_t seg_id)
+{
+        Mem_arena mem = (Mem_arena)memory;
+
+        if (!arena_mapped(memory, seg_id)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        arena_release(mem, mem->base.segments[seg_id],
+                      mem->base.lengths[seg_id]);
+        mem->base.segments[seg_id] = NULL;
+        mem->base.lengths[seg_id] = 0;
+        mem->free_ids[mem->num_free++] = seg_id;
+}
+
+/****************************** arena_duplicate *******************************
+ *
+ * Replaces segment 0 with a copy of the given segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by arena_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              none
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static void arena_duplicate(Mem_T memory, uint32_t seg_id)
+{
+        Mem_arena mem = (Mem_arena)memory;
+
+        uint32_t length = arena_length(memory, seg_id);
+        uint32_t *new_seg = arena_alloc(mem, length);
+        memcpy(new_seg, mem->base.segments[seg_id], length * sizeof(uint32_t));
+
+        arena_release(mem, mem->base.segments[0], mem->base.lengths[0]);
+        mem->base.segments[0] = new_seg;
+        mem->base.lengths[0] = length;
+}
+
+const Mem_vtable Mem_arena_backend = {
+        "arena",
+        arena_new,
+        arena_free,
+        arena_word_at,
+        arena_mapped,
+        arena_length,
+        arena_map,
+        arena_unmap,
+        arena_duplicate
+};
+
+#undef HINT
+#undef CHUNK_WORDS
+#undef MAX_SMALL
@@ -0,0 +1,43 @@
+/*
+ *      memory_backend.h
+ *      by Cansu Birsen (cbirse01), Ayse Idil Kolabas (akolab01)
+ *      November 12, 2023
+ *      UM Emulator
+ *
+ *      Private interface between memory_management.c and the memory
+ *      backends. Each backend fills in a Mem_vtable with its own versions of
+ *      the memory_management.h functions and starts its memory structure
+ *      with a struct Mem_T, so memory_management.c can find the vtable of
+ *      any memory it is handed. Backends with a C array of segments also
+ *      keep the segments, lengths and num_segments of that struct Mem_T up
+ *      to date. Clients should only include memory_management.h.
+ */
+
+
+#ifndef MEMORY_BACKEND_INCLUDED
+#define MEMORY_BACKEND_INCLUDED
+
+/* Hanson Libraries */
+#include <except.h>
+
+/* Custom .h files */
+#include "memory_management.h"
+
+/* operations every backend provides, see memory_management.c */
+typedef struct Mem_vtable {
+        const char *name;
+        Mem_T (*new)(uint32_t *program, uint32_t length);
+        void (*free)(Mem_T memory);
+        uint32_t *(*word_at)(Mem_T memory, uint32_t seg_id, uint32_t offset);
+        bool (*mapped)(Mem_T memory, uint32_t seg_id);
+        uint32_t (*length)(Mem_T memory, uint32_t seg_id);
+        uint32_t (*map)(Mem_T memory, uint32_t num_words);
+        void (*unmap)(Mem_T memory, uint32_t seg_id);
+        void (*duplicate)(Mem_T memory, uint32_t seg_id);
+} Mem_vtable;
+
+extern const Mem_vtable Mem_seq_backend;
+extern const Mem_vtable Mem_flat_backend;
+extern const Mem_vtable Mem_arena_backend;
+
+#endif
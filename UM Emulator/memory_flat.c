@@ -0,0 +1,304 @@
+/*
+ *      memory_flat.c
+ *      by Cansu Birsen (cbirse01), Ayse Idil Kolabas (akolab01)
+ *      November 12, 2023
+ *      UM Emulator
+ *
+ *      Flat memory backend. Memory is a growable C array of pointers to
+ *      malloc'd segments, with a parallel array of segment lengths, so a word
+ *      is reached with two loads and no calls into Hanson's data structures.
+ *      NULL stands for an unmapped segment. The ids of unmapped segments are
+ *      kept on a growable stack.
+ */
+
+
+/* Hanson Libraries */
+#include <assert.h>
+#include <mem.h>
+#include <string.h>
+
+/* Custom .h files */
+#include "memory_backend.h"
+
+/* Number of segment slots memory starts with */
+#define HINT 1024
+
+/* memory as seen by this backend */
+typedef struct Mem_flat {
+        struct Mem_T base;
+        uint32_t capacity;
+        uint32_t *free_ids;
+        uint32_t num_free;
+} *Mem_flat;
+
+/******************************** flat_new *********************************
+ *
+ * Creates flat memory with the program copied into segment 0
+ *
+ * Inputs:
+ *              uint32_t *program: 32-bit words representing the program
+ *              uint32_t length: number of words in program
+ * Return:
+ *              the new memory
+ * Expects:
+ *              allocations to succeed
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static Mem_T flat_new(uint32_t *program, uint32_t length)
+{
+        Mem_flat mem;
+        NEW(mem);
+        mem->base.vtable = &Mem_flat_backend;
+
+        mem->capacity = HINT;
+        mem->base.segments = malloc(HINT * sizeof(uint32_t *));
+        mem->base.lengths = malloc(HINT * sizeof(uint32_t));
+        mem->free_ids = malloc(HINT * sizeof(uint32_t));
+        assert(mem->base.segments != NULL && mem->base.lengths != NULL);
+        assert(mem->free_ids != NULL);
+        mem->num_free = 0;
+
+        /* at least one word is allocated so segment 0 is never NULL */
+        mem->base.segments[0] = malloc((length == 0 ? 1 : length) *
+                                       sizeof(uint32_t));
+        assert(mem->base.segments[0] != NULL);
+        memcpy(mem->base.segments[0], program, length * sizeof(uint32_t));
+        mem->base.lengths[0] = length;
+        mem->base.num_segments = 1;
+
+        return &mem->base;
+}
+
+/******************************** flat_free *********************************
+ *
+ * Frees every mapped segment, the arrays and the memory
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by flat_new
+ * Return:
+ *              none
+ * Expects:
+ *              memory to not be null
+ * Notes:
+ *              none
+ *
+ *****************************************************************************/
+static void flat_free(Mem_T memory)
+{
+        Mem_flat mem = (Mem_flat)memory;
+
+        /* free(NULL) does nothing, so unmapped slots need no check */
+        for (uint32_t i = 0; i < mem->base.num_segments; i++) {
+                free(mem->base.segments[i]);
+        }
+
+        free(mem->base.segments);
+        free(mem->base.lengths);
+        free(mem->free_ids);
+        FREE(mem);
+}
+
+/******************************** flat_word_at *******************************
+ *
+ * Returns a pointer to the word in the given offset of the segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by flat_new
+ *              uint32_t seg_id: id of a mapped segment
+ *              uint32_t offset: index of the word in the segment
+ * Return:
+ *              pointer to the word
+ * Expects:
+ *              segment to be mapped and offset to be in bounds
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectations fail. an unmapped
+ *              segment has length 0, so one check covers both
+ *
+ *****************************************************************************/
+static uint32_t *flat_word_at(Mem_T memory, uint32_t seg_id, uint32_t offset)
+{
+        Mem_flat mem = (Mem_flat)memory;
+
+        if (seg_id >= mem->base.num_segments ||
+            offset >= mem->base.lengths[seg_id]) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return &mem->base.segments[seg_id][offset];
+}
+
+/******************************** flat_mapped *********************************
+ *
+ * Returns whether the segment with the given id is mapped
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by flat_new
+ *              uint32_t seg_id: id of the segment
+ * Return:
+ *              true if the segment is mapped
+ * Expects:
+ *              none
+ * Notes:
+ *              ids past the end of memory are unmapped
+ *
+ *****************************************************************************/
+static bool flat_mapped(Mem_T memory, uint32_t seg_id)
+{
+        Mem_flat mem = (Mem_flat)memory;
+
+        return seg_id < mem->base.num_segments &&
+               mem->base.segments[seg_id] != NULL;
+}
+
+/******************************** flat_length *********************************
+ *
+ * Returns number of words within a segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by flat_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              the number of words in the segment
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static uint32_t flat_length(Mem_T memory, uint32_t seg_id)
+{
+        Mem_flat mem = (Mem_flat)memory;
+
+        if (!flat_mapped(memory, seg_id)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return mem->base.lengths[seg_id];
+}
+
+/******************************** flat_map *********************************
+ *
+ * Maps a zeroed segment at the most recently unmapped id, or at a new id at
+ * the end of memory. The arrays double when they are full.
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by flat_new
+ *              uint32_t num_words: number of words in the new segment
+ * Return:
+ *              id of the new segment
+ * Expects:
+ *              allocations to succeed
+ * Notes:
+ *              will CRE if expectation fails
+ *
+ *****************************************************************************/
+static uint32_t flat_map(Mem_T memory, uint32_t num_words)
+{
+        Mem_flat mem = (Mem_flat)memory;
+
+        /* at least one word is allocated so a mapped segment is never NULL */
+        uint32_t *new_seg = calloc(num_words == 0 ? 1 : num_words,
+                                   sizeof(uint32_t));
+        assert(new_seg != NULL);
+
+        uint32_t segment_id;
+        if (mem->num_free > 0) {
+                segment_id = mem->free_ids[--mem->num_free];
+        } else {
+                if (mem->base.num_segments == mem->capacity) {
+                        mem->capacity *= 2;
+                        RESIZE(mem->base.segments,
+                               mem->capacity * sizeof(uint32_t *));
+                        RESIZE(mem->base.lengths,
+                               mem->capacity * sizeof(uint32_t));
+                        RESIZE(mem->free_ids,
+                               mem->capacity * sizeof(uint32_t));
+                        assert(mem->base.segments != NULL);
+                        assert(mem->base.lengths != NULL);
+                        assert(mem->free_ids != NULL);
+                }
+                segment_id = mem->base.num_segments++;
+        }
+
+        mem->base.segments[segment_id] = new_seg;
+        mem->base.lengths[segment_id] = num_words;
+
+        return segment_id;
+}
+
+/******************************** flat_unmap *********************************
+ *
+ * Frees the segment and pushes its id on the free id stack
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by flat_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              none
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *              the free id stack never overflows, as it is as large as the
+ *              array of segments
+ *
+ *****************************************************************************/
+static void flat_unmap(Mem_T memory, uint32_t seg_id)
+{
+        Mem_flat mem = (Mem_flat)memory;
+
+        if (!flat_mapped(memory, seg_id)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        free(mem->base.segments[seg_id]);
+        mem->base.segments[seg_id] = NULL;
+        mem->base.lengths[seg_id] = 0;
+        mem->free_ids[mem->num_free++] = seg_id;
+}
+
+/****************************** flat_duplicate *******************************
+ *
+ * Replaces segment 0 with a copy of the given segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by flat_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              none
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static void flat_duplicate(Mem_T memory, uint32_t seg_id)
+{
+        Mem_flat mem = (Mem_flat)memory;
+
+        uint32_t length = flat_length(memory, seg_id);
+        uint32_t *new_seg = malloc((length == 0 ? 1 : length) *
+                                   sizeof(uint32_t));
+        assert(new_seg != NULL);
+        memcpy(new_seg, mem->base.segments[seg_id], length * sizeof(uint32_t));
+
+        free(mem->base.segments[0]);
+        mem->base.segments[0] = new_seg;
+        mem->base.lengths[0] = length;
+}
+
+const Mem_vtable Mem_flat_backend = {
+        "flat",
+        flat_new,
+        flat_free,
+        flat_word_at,
+        flat_mapped,
+        flat_length,
+        flat_map,
+        flat_unmap,
+        flat_duplicate
+};
+
+#undef HINT
@@ -5,396 +5,290 @@
  *      UM Emulator
  *
  *      Implementation for the memory_management.h file. Functions in this file
- *      are used to created a segmented memory structure, add new segment, 
- *      access to a specific segment or to a word at a given offset in a 
- *      specific segment, add a word to a given segment, get the length of 
- *      a segment or the total number of segments in the memory (mapped or 
- *      unmapped) and free the memory allocated for this module.
+ *      are used to created a segmented memory structure, map and unmap
+ *      segments, access to a word at a given offset in a specific segment,
+ *      get the length of a segment, duplicate a segment into segment 0 and
+ *      free the memory allocated for this module.
+ *
+ *      Each function forwards to the backend the memory was created with.
+ *      The backends live in memory_seq.c, memory_flat.c and memory_arena.c.
  */
 
 
 /* Hanson Libraries */
 #include <assert.h>
-#include <stdint.h>
-#include <except.h>
+#include <string.h>
 
 /* Custom .h files */
-#include "memory_management.h"
-
-/* Hint value definition for memory initiation */
-#define HINT 10000
+#include "memory_backend.h"
 
 /* Exception for when segment or word to be retrieved is out of bounds */
 Except_T Bad_Bounds_Mem = { "Index out of bounds" };
 
+/* backends in the order of the Mem_backend enum */
+static const Mem_vtable *backends[MEM_NUM_BACKENDS] = {
+        &Mem_seq_backend,
+        &Mem_flat_backend,
+        &Mem_arena_backend
+};
+
 /******************************** memory_new *********************************
  *
- * Creates and returns a sequence representing segmented memory where each
- * element is a uarray of uint32_t's. Initializes the first element of the 
- * memory sequence to be the uarray of words representing the program.
+ * Creates and returns segmented memory stored by the given backend, with
+ * segment 0 holding a copy of the program.
  *
  * Inputs:
- *              UArray_T program: UArray of 32-bit words representing the 
- *                                program being run
+ *              Mem_backend backend: which backend stores the memory
+ *              uint32_t *program: array of 32-bit words representing the
+ *                                 program being run
+ *              uint32_t length: number of words in program
  * Return:
- *              sequence of uarrays of 32-bit words representing
- *                    segmented memory
+ *              memory with the program mapped as segment 0
  * Expects:
- *              program to not be null and memory to be successfully
- *              instantiated
+ *              backend to be one of the Mem_backend values, program to not
+ *              be null unless length is 0
  * Notes:
  *              will CRE if expectations fail
- *              it's the user's responsibility to call memory_free to free 
- *              the memory sequence and the segment sequences stored in it
+ *              it's the user's responsibility to call memory_free to free
+ *              the memory and every segment still mapped in it
  *
  *****************************************************************************/
-Seq_T memory_new(UArray_T program)
+Mem_T memory_new(Mem_backend backend, uint32_t *program, uint32_t length)
 {
-        assert(program != NULL);
-        
-        /* Initialize memory sequence */
-        Seq_T mem = Seq_new(HINT);
+        assert(backend < MEM_NUM_BACKENDS);
+        assert(program != NULL || length == 0);
+
+        Mem_T mem = backends[backend]->new(program, length);
         assert(mem != NULL);
 
-        /* Push uarray representing program as the first element of memory */
-        Seq_addhi(mem, program);
         return mem;
 }
 
-
-/******************************** segment_put *********************************
+/******************************** memory_free *********************************
  *
- * puts given segment to memory in the specific id given
+ * Frees every mapped segment, the id manager and the memory itself
  *
  * Inputs:
- *              Seq_T memory: Sequence of sequences of 32-bit words 
- *                            representing a segmented memory
- *              int segment_id: which index the segment will be placed at
- *              void *value: segment to be placed into memory when dereferenced
+ *              Mem_T *memory: pointer to the memory to be freed
  * Return:
  *              none
  * Expects:
- *              memory to not be null
- *              index to be in bounds of memory
+ *              pointer to memory and memory to not be null
  * Notes:
  *              will CRE if expectations fail
+ *              sets *memory to NULL
  *
  *****************************************************************************/
-void segment_put(Seq_T memory, int segment_id, void *value)
+void memory_free(Mem_T *memory)
 {
-        /* check requirements */
+        /* checks for requirements */
         assert(memory != NULL);
+        assert(*memory != NULL);
 
-        /* check id bounds */
-        if (segment_id >= Seq_length(memory) || segment_id < 0) {
-                RAISE(Bad_Bounds_Mem);
-        }
-
-        /* push value to specific segment in memory */
-        Seq_put(memory, segment_id, value);
+        (*memory)->vtable->free(*memory);
+        *memory = NULL;
 }
 
-/******************************** segment_add *********************************
+/****************************** backend_word_at ******************************
  *
- * Adds the given segment as the last element of the given memory sequence 
+ * Asks the backend for a pointer to a word. word_at calls this for backends
+ * that do not keep a segment array in the Mem_T.
  *
  * Inputs:
- *              Seq_T memory: Sequence of uarrays that the segment will be
- *                            added onto, representing memory
- *              void *elem: uarray of uint32_t words that represents a segment
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of a mapped segment
+ *              uint32_t offset: index of the word in the segment
  * Return:
- *              none
+ *              pointer to the word
  * Expects:
- *              memory and segment to not be null
+ *              memory to not be null
  * Notes:
- *              will CRE if expectations fail
+ *              will raise Bad_Bounds_Mem like word_at
  *
  *****************************************************************************/
-void segment_add(Seq_T memory, void *segment)
+uint32_t *backend_word_at(Mem_T memory, uint32_t seg_id, uint32_t offset)
 {
-        /* check for requirements */
-        assert(memory != NULL);
-        assert(segment != NULL);
-        
-        /* push new instruction to segment */
-        Seq_addhi(memory, segment);
+        return memory->vtable->word_at(memory, seg_id, offset);
 }
 
-
-/******************************** segment_at *********************************
+/****************************** backend_mapped *******************************
  *
- * Returns a pointer to the segment sequence at the given index of the memory 
+ * Asks the backend whether a segment is mapped, for segment_mapped
  *
  * Inputs:
- *              Seq_T memory: Sequence of uarrays that holds segments, 
- *                            representing memory
- *              int seg_id  : The index where the desired segment is at in the
- *                            memory
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of the segment
  * Return:
- *              pointer to the segment at the given index in memory
+ *              true if the segment is mapped
  * Expects:
- *              memory to not be null and index to not be out of memory bounds
+ *              memory to not be null
  * Notes:
- *              will CRE if memory is null, and will cause Unchecked Runtime 
- *              Error by raising Bad_Bounds_Mem exception if index is out of 
- *              bounds
+ *              none
  *
  *****************************************************************************/
-void *segment_at(Seq_T memory, int seg_id)
+bool backend_mapped(Mem_T memory, uint32_t seg_id)
 {
-        /* check for requirements */
-        assert(memory != NULL);
-
-        /* bounds checking for memory */
-        if (seg_id >= Seq_length(memory) || seg_id < 0) {
-                RAISE(Bad_Bounds_Mem);
-        }
-        
-        /* returns the segment at specified seg_id */
-        return Seq_get(memory, seg_id);
+        return memory->vtable->mapped(memory, seg_id);
 }
 
-/******************************** word_at *********************************
+/****************************** backend_length ********************************
  *
- * Returns a pointer to the word in the given offset of the segment
+ * Asks the backend for the length of a segment, for get_length_seg
  *
  * Inputs:
- *              UArray_T segment: uarray of uint32_t words, representing
- *                                a segment in memory
- *              int offset      : the index where the desired word is at
- *                                in the segment
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of a mapped segment
  * Return:
- *              pointer to the word in the given offset of the segment
+ *              the number of words in the segment
  * Expects:
- *              segment to not be null and offset to not be
- *              out of bounds for the segment
+ *              memory to not be null
  * Notes:
- *              will CRE if segment is null, and will cause Unchecked Runtime 
- *              Error by raising Bad_Bounds_Mem exception if offset is out of 
- *              bounds
+ *              will raise Bad_Bounds_Mem like get_length_seg
  *
  *****************************************************************************/
-void *word_at(UArray_T segment, int offset)
+uint32_t backend_length(Mem_T memory, uint32_t seg_id)
 {
-        /* checks for requirements */
-        assert(segment != NULL);
-
-        /* bounds checking for segment */
-        if (offset >= UArray_length(segment) || offset < 0) {
-                RAISE(Bad_Bounds_Mem);
-        }
-
-        /* returns instruction at specified offset */
-        return UArray_at(segment, offset);
+        return memory->vtable->length(memory, seg_id);
 }
 
-/******************************** memory_free *********************************
+/*************************** backend_segment_words ****************************
  *
- * Frees the uarrays representing segments within the sequence representing
- * memory, and frees the spine of memory
+ * Asks the backend for the first word of a segment, for segment_words
  *
  * Inputs:
- *              Seq_T *memory: Sequence of uarrays of 32-bit words 
- *                             representing a segmented memory
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of a mapped segment
  * Return:
- *              none
+ *              pointer to the words of the segment, NULL for an empty one
  * Expects:
- *              pointer to memory and memory to not be null
+ *              memory to not be null
  * Notes:
- *              will CRE if expectations fail
+ *              will raise Bad_Bounds_Mem if the segment is not mapped
  *
  *****************************************************************************/
-void memory_free(Seq_T *memory)
+uint32_t *backend_segment_words(Mem_T memory, uint32_t seg_id)
 {
-        /* checks for requirements */
-        assert(memory != NULL);
-        assert(*memory != NULL);
-        
-        /* gets number of segments */
-        int lengthmem = Seq_length(*memory);
-        
-        /* goes through each segment */
-        for (int i = 0; i < lengthmem; i++) {
-                UArray_T segment = Seq_remlo(*memory);
-                /* frees non-null segments */
-                if (segment != NULL) {
-                        UArray_free(&segment);
-                }
+        if (memory->vtable->length(memory, seg_id) == 0) {
+                return NULL;
         }
 
-        /* frees spine of memory structure */
-        Seq_free(memory);
+        return memory->vtable->word_at(memory, seg_id, 0);
 }
 
-/******************************** free_seg *********************************
+/******************************** segment_map *********************************
  *
- * Frees given segment. This function will only be called when initiating
- * the program to memory. No other segment will be represented as a sequence.
+ * Maps a new segment with every word set to 0 and returns its id. The id
+ * of an unmapped segment is reused if there is one.
  *
  * Inputs:
- *              Seq_T seg: Sequence of uint32_t words to initiate program
+ *              Mem_T memory: memory to map the segment in
+ *              uint32_t num_words: number of words in the new segment
  * Return:
- *              none
+ *              id of the new segment, never 0
  * Expects:
- *              provided segment to not be null
+ *              memory to not be null
  * Notes:
- *              will CRE if expectation fails
+ *              will CRE if expectation fails or allocation fails
  *
  *****************************************************************************/
-void free_seg(Seq_T seg)
+uint32_t segment_map(Mem_T memory, uint32_t num_words)
 {
-        /* check for requirements */
-        assert(seg != NULL);
-
-        /* get length of segment */
-        int lengthseg = Seq_length(seg);
-        
-        /* frees each word in segment */
-        for (int j = 0; j < lengthseg; j++) {
-                free(Seq_remlo(seg));
-        }
-
-        /* frees segment */
-        Seq_free(&seg);
+        assert(memory != NULL);
+        return memory->vtable->map(memory, num_words);
 }
 
-/******************************** get_length *********************************
+/******************************** segment_unmap *******************************
  *
- * Returns number of segments within memory or number of indices in id manager
- * depending on which sequence it is called on
+ * Unmaps the segment with the given id so its id can be reused
  *
  * Inputs:
- *              Seq_T seq: sequence to calculate the length of
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of the segment to unmap
  * Return:
- *              the number of elements of the given sequence
+ *              none
  * Expects:
- *              seq to not be null
+ *              memory to not be null and seg_id to be a mapped segment other
+ *              than segment 0
  * Notes:
- *              will CRE if expectation fails
+ *              will CRE if memory is null
+ *              the caller checks for segment 0 and unmapped segments, the
+ *              backends raise Bad_Bounds_Mem for them
  *
  *****************************************************************************/
-int get_length(Seq_T seq)
+void segment_unmap(Mem_T memory, uint32_t seg_id)
 {
-        assert(seq != NULL);
-        return Seq_length(seq);
+        assert(memory != NULL);
+        memory->vtable->unmap(memory, seg_id);
 }
 
-/******************************** get_length_seg ******************************
+/****************************** segment_duplicate *****************************
  *
- * Returns number of words within a segment
+ * Replaces segment 0 with a copy of the segment with the given id
  *
  * Inputs:
- *              UArray_T seg: segment to calculate the length of
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of a mapped segment other than 0
  * Return:
- *              the number of elements of the given segment
+ *              none
  * Expects:
- *              seg to not be null
+ *              memory to not be null and the segment to be mapped
  * Notes:
- *              will CRE if expectation fails
+ *              will CRE if memory is null
+ *              will raise Bad_Bounds_Mem if the segment is not mapped
  *
  *****************************************************************************/
-int get_length_seg(UArray_T seg)
+void segment_duplicate(Mem_T memory, uint32_t seg_id)
 {
-        assert(seg != NULL);
-        return UArray_length(seg);
+        assert(memory != NULL);
+        memory->vtable->duplicate(memory, seg_id);
 }
 
-/******************************** id_m_new *********************************
+/**************************** memory_backend_name *****************************
  *
- * Creates and returns a sequence representing the free ids within a memory
- * representation.
+ * Returns the name used to select the given backend on the command line
  *
  * Inputs:
- *              n/a
+ *              Mem_backend backend: one of the Mem_backend values
  * Return:
- *              sequence of 32-bit words representing free segments that can
- *              be mapped to in memory
+ *              name of the backend
  * Expects:
- *              id manager to be successfully instantiated
+ *              backend to be one of the Mem_backend values
  * Notes:
- *              will CRE if expectations fail
- *              it's the user's responsibility to free the id manager by 
- *              calling id_m_free function
+ *              will CRE if expectation fails
  *
  *****************************************************************************/
-Seq_T id_m_new()
+const char *memory_backend_name(Mem_backend backend)
 {
-        Seq_T id_m = Seq_new(HINT);
-        assert(id_m != NULL);
-
-        return id_m;
+        assert(backend < MEM_NUM_BACKENDS);
+        return backends[backend]->name;
 }
 
-/******************************** id_m_add *********************************
+/**************************** memory_backend_find *****************************
  *
- * Creates and returns a sequence representing the free ids within a memory
- * representation.
+ * Looks up a backend by the name memory_backend_name gives it
  *
  * Inputs:
- *              Seq_T id_m: sequence of 32-bit words representing free segments
- *                          that can be mapped to in memory
- *              uint32_t id: 32-bit word representing a free segment's id
+ *              const char *name: name of the backend
+ *              Mem_backend *backend: where the backend found is stored
  * Return:
- *              n/a
+ *              true if a backend has that name, false otherwise
  * Expects:
- *              id_m to not be null
+ *              name and backend to not be null
  * Notes:
  *              will CRE if expectations fail
- *****************************************************************************/
-void id_m_add(Seq_T id_m, uint32_t id)
-{
-        assert(id_m != NULL);
-        
-        /* push new free id to id manager */
-        Seq_addlo(id_m, (void *)(uintptr_t)id);
-}
-
-/******************************** id_m_pop *********************************
- *
- * Returns a free id in memory to map a segment into.
  *
- * Inputs:
- *              Seq_T id_m: sequence of 32-bit words representing free segments
- *                          that can be mapped to in memory
- * Return:
- *              uint32_t id representing a free segment's id
- * Expects:
- *              id_m to not be null
- * Notes:
- *              will CRE if expectations fail
  *****************************************************************************/
-uint32_t id_m_pop(Seq_T id_m)
+bool memory_backend_find(const char *name, Mem_backend *backend)
 {
-        assert(id_m != NULL);
-        
-        /* returns a free id to be mapped to */
-        return (uint32_t)(uintptr_t)Seq_remlo(id_m);
-}
+        assert(name != NULL);
+        assert(backend != NULL);
 
-/******************************** id_m_free *********************************
- *
- * Frees the id manager representing the free indices where segments can be
- * mapped to in memory
- *
- * Inputs:
- *              Seq_T *id_m: Sequence of uint32_t words representing free
- *                           segment indices to be freed
- * Return:
- *              none
- * Expects:
- *              pointer to id_m and id_m to not be null
- * Notes:
- *              will CRE if expectations fail
- *
- *****************************************************************************/
-void id_m_free(Seq_T *id_m)
-{
-        /* checks for requirements */
-        assert(id_m != NULL);
-        assert(*id_m != NULL);
-        
-        /* frees id_m structure */
-        Seq_free(id_m);
-}
+        for (int i = 0; i < MEM_NUM_BACKENDS; i++) {
+                if (strcmp(name, backends[i]->name) == 0) {
+                        *backend = (Mem_backend)i;
+                        return true;
+                }
+        }
 
-#undef HINT
\ No newline at end of file
+        return false;
+}
@@ -5,11 +5,17 @@
  *      UM Emulator
  *
  *      Interface for the memory_management.h file. Functions in this file
- *      are used to created a segmented memory structure, add new segment, 
- *      access to a specific segment or to a word at a given offset in a 
- *      specific segment, add a word to a given segment, get the length of 
- *      a segment or the total number of segments in the memory (mapped or 
- *      unmapped) and free the memory allocated for this module.
+ *      are used to created a segmented memory structure, map and unmap
+ *      segments, access to a word at a given offset in a specific segment,
+ *      get the length of a segment, duplicate a segment into segment 0 and
+ *      free the memory allocated for this module.
+ *
+ *      The memory is implemented by one of several backends chosen when it
+ *      is created, and the functions dispatch to the chosen backend. Word
+ *      access, mapped checks and lengths are static inline here, reading
+ *      the segment array that the flat and arena backends share, so the
+ *      interpreter only calls into a backend to map, unmap or load a
+ *      program.
  */
 
 
@@ -20,23 +26,177 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 /* Hanson Libraries */
-#include <seq.h>
-#include <uarray.h>
-
-extern Seq_T memory_new(UArray_T program);
-extern void segment_add(Seq_T memory, void *segment);
-extern void *segment_at(Seq_T memory, int seg_id);
-extern void *word_at(UArray_T segment, int offset);
-extern void segment_put(Seq_T memory, int segment_id, void *value);
-extern void free_seg(Seq_T seg);
-extern void memory_free(Seq_T *memory);
-extern int get_length(Seq_T mem);
-extern int get_length_seg(UArray_T seg);
-extern Seq_T id_m_new();
-extern void id_m_add(Seq_T id_m, uint32_t id);
-extern uint32_t id_m_pop(Seq_T id_m);
-extern void id_m_free(Seq_T *id_m);
-
-#endif
\ No newline at end of file
+#include <assert.h>
+#include <except.h>
+
+/* segmented memory, along with the ids of its unmapped segments. backends
+ * that keep their segments in a C array share it through segments and
+ * lengths, so words can be reached without a call. backends that do not set
+ * segments to NULL. unmapped segments are NULL with length 0
+ */
+typedef struct Mem_T {
+        const struct Mem_vtable *vtable;
+        uint32_t **segments;
+        uint32_t *lengths;
+        uint32_t num_segments;
+} *Mem_T;
+
+/* the ways segmented memory can be stored */
+typedef enum Mem_backend {
+        MEM_SEQ = 0,    /* Hanson sequence of uarrays, the original design */
+        MEM_FLAT,       /* growable array of pointers to malloc'd segments */
+        MEM_ARENA,      /* segments carved out of large chunks and recycled */
+        MEM_NUM_BACKENDS
+} Mem_backend;
+
+/* Raised when a segment id or word offset is out of bounds */
+extern Except_T Bad_Bounds_Mem;
+
+extern Mem_T memory_new(Mem_backend backend, uint32_t *program,
+                        uint32_t length);
+extern void memory_free(Mem_T *memory);
+extern uint32_t segment_map(Mem_T memory, uint32_t num_words);
+extern void segment_unmap(Mem_T memory, uint32_t seg_id);
+extern void segment_duplicate(Mem_T memory, uint32_t seg_id);
+extern const char *memory_backend_name(Mem_backend backend);
+extern bool memory_backend_find(const char *name, Mem_backend *backend);
+
+/* calls into the backend, for backends without a segment array */
+extern uint32_t *backend_word_at(Mem_T memory, uint32_t seg_id,
+                                 uint32_t offset);
+extern bool backend_mapped(Mem_T memory, uint32_t seg_id);
+extern uint32_t backend_length(Mem_T memory, uint32_t seg_id);
+extern uint32_t *backend_segment_words(Mem_T memory, uint32_t seg_id);
+
+/******************************** word_at *********************************
+ *
+ * Returns a pointer to the word in the given offset of the given segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of a mapped segment
+ *              uint32_t offset: the index where the desired word is at
+ *                               in the segment
+ * Return:
+ *              pointer to the word in the given offset of the segment
+ * Expects:
+ *              memory to not be null, segment to be mapped and offset to
+ *              not be out of bounds for the segment
+ * Notes:
+ *              will CRE if memory is null, and will cause Unchecked Runtime
+ *              Error by raising Bad_Bounds_Mem exception if the segment id
+ *              or offset is out of bounds. an unmapped segment has length 0,
+ *              so one check covers both
+ *
+ *****************************************************************************/
+static inline uint32_t *word_at(Mem_T memory, uint32_t seg_id,
+                                uint32_t offset)
+{
+        assert(memory != NULL);
+
+        if (memory->segments == NULL) {
+                return backend_word_at(memory, seg_id, offset);
+        }
+        if (seg_id >= memory->num_segments ||
+            offset >= memory->lengths[seg_id]) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return &memory->segments[seg_id][offset];
+}
+
+/****************************** segment_mapped *******************************
+ *
+ * Returns whether the segment with the given id is currently mapped
+ *
+ * Inputs:
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of the segment
+ * Return:
+ *              true if seg_id names a mapped segment, false otherwise
+ * Expects:
+ *              memory to not be null
+ * Notes:
+ *              will CRE if expectation fails
+ *              ids past the end of memory are reported as unmapped
+ *
+ *****************************************************************************/
+static inline bool segment_mapped(Mem_T memory, uint32_t seg_id)
+{
+        assert(memory != NULL);
+
+        if (memory->segments == NULL) {
+                return backend_mapped(memory, seg_id);
+        }
+
+        return seg_id < memory->num_segments &&
+               memory->segments[seg_id] != NULL;
+}
+
+/******************************** get_length_seg ******************************
+ *
+ * Returns number of words within a segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              the number of words of the given segment
+ * Expects:
+ *              memory to not be null and segment to be mapped
+ * Notes:
+ *              will CRE if memory is null
+ *              will raise Bad_Bounds_Mem if the segment is not mapped
+ *
+ *****************************************************************************/
+static inline uint32_t get_length_seg(Mem_T memory, uint32_t seg_id)
+{
+        assert(memory != NULL);
+
+        if (memory->segments == NULL) {
+                return backend_length(memory, seg_id);
+        }
+        if (!segment_mapped(memory, seg_id)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return memory->lengths[seg_id];
+}
+
+/****************************** segment_words ********************************
+ *
+ * Returns a pointer to the first word of a segment, so a client that
+ * checks offsets against get_length_seg itself can index it directly
+ *
+ * Inputs:
+ *              Mem_T memory: memory holding the segment
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              pointer to the words of the segment, NULL for an empty one
+ * Expects:
+ *              memory to not be null and segment to be mapped
+ * Notes:
+ *              will CRE if memory is null
+ *              will raise Bad_Bounds_Mem if the segment is not mapped
+ *              the pointer is only good until the segment is unmapped or,
+ *              for segment 0, until segment_duplicate is called
+ *
+ *****************************************************************************/
+static inline uint32_t *segment_words(Mem_T memory, uint32_t seg_id)
+{
+        assert(memory != NULL);
+
+        if (memory->segments == NULL) {
+                return backend_segment_words(memory, seg_id);
+        }
+        if (!segment_mapped(memory, seg_id)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return memory->segments[seg_id];
+}
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ *      memory_seq.c
+ *      by Cansu Birsen (cbirse01), Ayse Idil Kolabas (akolab01)
+ *      November 12, 2023
+ *      UM Emulator
+ *
+ *      The original memory backend. Memory is a sequence of uarrays of
+ *      uint32_t words, each uarray representing a segment and NULL standing
+ *      for an unmapped segment. A second sequence, the id manager, holds the
+ *      ids of unmapped segments so they can be mapped again.
+ */
+
+
+/* Hanson Libraries */
+#include <assert.h>
+#include <mem.h>
+#include <seq.h>
+#include <uarray.h>
+
+/* Custom .h files */
+#include "memory_backend.h"
+
+/* Hint value definition for memory initiation */
+#define HINT 10000
+
+/* memory as seen by this backend */
+typedef struct Mem_seq {
+        struct Mem_T base;
+        Seq_T segments;
+        Seq_T id_m;
+} *Mem_seq;
+
+/******************************** segment_at *********************************
+ *
+ * Returns the uarray of the segment at the given index of the memory
+ *
+ * Inputs:
+ *              Mem_seq mem: memory holding segments
+ *              uint32_t seg_id: the index where the desired segment is at in
+ *                               the memory
+ * Return:
+ *              uarray of the segment, NULL if it is unmapped
+ * Expects:
+ *              index to not be out of memory bounds
+ * Notes:
+ *              will cause Unchecked Runtime Error by raising Bad_Bounds_Mem
+ *              exception if index is out of bounds
+ *
+ *****************************************************************************/
+static UArray_T segment_at(Mem_seq mem, uint32_t seg_id)
+{
+        /* bounds checking for memory */
+        if (seg_id >= (uint32_t)Seq_length(mem->segments)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        /* returns the segment at specified seg_id */
+        return Seq_get(mem->segments, seg_id);
+}
+
+/******************************** seq_new *********************************
+ *
+ * Creates a sequence representing segmented memory where each element is a
+ * uarray of uint32_t's, with the program copied into the first element,
+ * and an empty id manager.
+ *
+ * Inputs:
+ *              uint32_t *program: 32-bit words representing the program
+ *              uint32_t length: number of words in program
+ * Return:
+ *              the new memory
+ * Expects:
+ *              memory to be successfully instantiated
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static Mem_T seq_new(uint32_t *program, uint32_t length)
+{
+        Mem_seq mem;
+        NEW(mem);
+        mem->base.vtable = &Mem_seq_backend;
+
+        /* segments are uarrays, so every access goes through the vtable */
+        mem->base.segments = NULL;
+        mem->base.lengths = NULL;
+        mem->base.num_segments = 0;
+
+        /* Initialize memory sequence and id manager */
+        mem->segments = Seq_new(HINT);
+        mem->id_m = Seq_new(HINT);
+        assert(mem->segments != NULL && mem->id_m != NULL);
+
+        /* Push uarray representing program as the first element of memory */
+        UArray_T seg_0 = UArray_new(length, sizeof(uint32_t));
+        for (uint32_t i = 0; i < length; i++) {
+                *(uint32_t *)UArray_at(seg_0, i) = program[i];
+        }
+        Seq_addhi(mem->segments, seg_0);
+
+        return &mem->base;
+}
+
+/******************************** seq_free *********************************
+ *
+ * Frees the uarrays representing segments within the sequence representing
+ * memory, the spine of memory and the id manager
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by seq_new
+ * Return:
+ *              none
+ * Expects:
+ *              memory to not be null
+ * Notes:
+ *              will CRE if expectations fail
+ *
+ *****************************************************************************/
+static void seq_free(Mem_T memory)
+{
+        Mem_seq mem = (Mem_seq)memory;
+
+        /* goes through each segment */
+        int lengthmem = Seq_length(mem->segments);
+        for (int i = 0; i < lengthmem; i++) {
+                UArray_T segment = Seq_remlo(mem->segments);
+                /* frees non-null segments */
+                if (segment != NULL) {
+                        UArray_free(&segment);
+                }
+        }
+
+        /* frees spine of memory structure and id manager */
+        Seq_free(&mem->segments);
+        Seq_free(&mem->id_m);
+        FREE(mem);
+}
+
+/******************************** seq_word_at *********************************
+ *
+ * Returns a pointer to the word in the given offset of the segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by seq_new
+ *              uint32_t seg_id: id of a mapped segment
+ *              uint32_t offset: the index where the desired word is at
+ *                               in the segment
+ * Return:
+ *              pointer to the word in the given offset of the segment
+ * Expects:
+ *              segment to be mapped and offset to not be out of bounds
+ * Notes:
+ *              will cause Unchecked Runtime Error by raising Bad_Bounds_Mem
+ *              exception if expectations fail
+ *
+ *****************************************************************************/
+static uint32_t *seq_word_at(Mem_T memory, uint32_t seg_id, uint32_t offset)
+{
+        UArray_T segment = segment_at((Mem_seq)memory, seg_id);
+
+        /* bounds checking for segment */
+        if (segment == NULL || offset >= (uint32_t)UArray_length(segment)) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        /* returns instruction at specified offset */
+        return UArray_at(segment, offset);
+}
+
+/******************************** seq_mapped *********************************
+ *
+ * Returns whether the segment with the given id is mapped
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by seq_new
+ *              uint32_t seg_id: id of the segment
+ * Return:
+ *              true if the segment is mapped
+ * Expects:
+ *              none
+ * Notes:
+ *              ids past the end of memory are unmapped
+ *
+ *****************************************************************************/
+static bool seq_mapped(Mem_T memory, uint32_t seg_id)
+{
+        Mem_seq mem = (Mem_seq)memory;
+
+        return seg_id < (uint32_t)Seq_length(mem->segments) &&
+               Seq_get(mem->segments, seg_id) != NULL;
+}
+
+/******************************** seq_length *********************************
+ *
+ * Returns number of words within a segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by seq_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              the number of words in the segment
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static uint32_t seq_length(Mem_T memory, uint32_t seg_id)
+{
+        UArray_T segment = segment_at((Mem_seq)memory, seg_id);
+        if (segment == NULL) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        return UArray_length(segment);
+}
+
+/******************************** seq_map *********************************
+ *
+ * Maps a new uarray with every word set to 0. If there is no id available in
+ * the id manager, the segment is added to the end of memory. If there is,
+ * the segment is placed at that id.
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by seq_new
+ *              uint32_t num_words: number of words in the new segment
+ * Return:
+ *              id of the new segment
+ * Expects:
+ *              uarray to be successfully instantiated
+ * Notes:
+ *              will CRE if expectation fails
+ *
+ *****************************************************************************/
+static uint32_t seq_map(Mem_T memory, uint32_t num_words)
+{
+        Mem_seq mem = (Mem_seq)memory;
+
+        /* initialize the new segment with 0's as words */
+        UArray_T new_seg = UArray_new(num_words, sizeof(uint32_t));
+        for (uint32_t i = 0; i < num_words; i++) {
+                *(uint32_t *)UArray_at(new_seg, i) = (uint32_t)0;
+        }
+
+        if (Seq_length(mem->id_m) == 0) {
+                Seq_addhi(mem->segments, new_seg);
+                return Seq_length(mem->segments) - 1;
+        }
+
+        uint32_t segment_id = (uint32_t)(uintptr_t)Seq_remlo(mem->id_m);
+        Seq_put(mem->segments, segment_id, new_seg);
+
+        return segment_id;
+}
+
+/******************************** seq_unmap *********************************
+ *
+ * Frees the uarray of the segment, places NULL in its place and adds its id
+ * to the id manager
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by seq_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              none
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static void seq_unmap(Mem_T memory, uint32_t seg_id)
+{
+        Mem_seq mem = (Mem_seq)memory;
+
+        UArray_T unmap_seg = segment_at(mem, seg_id);
+        if (unmap_seg == NULL) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        UArray_free(&unmap_seg);
+        Seq_put(mem->segments, seg_id, NULL);
+        Seq_addlo(mem->id_m, (void *)(uintptr_t)seg_id);
+}
+
+/****************************** seq_duplicate *******************************
+ *
+ * Replaces the uarray of segment 0 with a copy of the given segment
+ *
+ * Inputs:
+ *              Mem_T memory: memory created by seq_new
+ *              uint32_t seg_id: id of a mapped segment
+ * Return:
+ *              none
+ * Expects:
+ *              segment to be mapped
+ * Notes:
+ *              will raise Bad_Bounds_Mem if expectation fails
+ *
+ *****************************************************************************/
+static void seq_duplicate(Mem_T memory, uint32_t seg_id)
+{
+        Mem_seq mem = (Mem_seq)memory;
+
+        UArray_T dup = segment_at(mem, seg_id);
+        if (dup == NULL) {
+                RAISE(Bad_Bounds_Mem);
+        }
+
+        /* UArray_copy keeps the length and copies every word */
+        UArray_T new_seg = UArray_copy(dup, UArray_length(dup));
+
+        UArray_T old_seg = Seq_put(mem->segments, 0, new_seg);
+        UArray_free(&old_seg);
+}
+
+const Mem_vtable Mem_seq_backend = {
+        "seq",
+        seq_new,
+        seq_free,
+        seq_word_at,
+        seq_mapped,
+        seq_length,
+        seq_map,
+        seq_unmap,
+        seq_duplicate
+};
+
+#undef HINT
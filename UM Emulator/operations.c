@@ -16,6 +16,7 @@
 /* Hanson Libraries */
 #include <assert.h>
 #include <stdbool.h>
+#include <seq.h>
 
 /* Custom .h files */
 #include "operations.h"
@@ -52,31 +53,40 @@ Except_T Word_Bounds = { "Word Index Out Of Bounds" };
 Except_T Faulty_Unmap = { "Refers to Unmapped Segment or Segment Zero" };
 
 /* Helper Function Declarations */
-void word_interpreter(Seq_T mem, UArray_T registers, Seq_T id_m);
-void conditional_move(int reg_a, int reg_b, int reg_c, UArray_T reg);
-void segmented_load(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg);
-void segmented_store(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg);
-void addition(int reg_a, int reg_b, int reg_c, UArray_T reg);
-void multiplication(int reg_a, int reg_b, int reg_c, UArray_T reg);
-void division(int reg_a, int reg_b, int reg_c, UArray_T reg);
-void bitwise_nand(int reg_a, int reg_b, int reg_c, UArray_T reg);
-void map_segment(int reg_b, int reg_c, Seq_T mem, UArray_T reg, Seq_T id_m);
-void unmap_segment(int reg_c, Seq_T mem, UArray_T reg, Seq_T id_m);
-void output(int reg_c, UArray_T reg);
-void input(int reg_c, UArray_T reg);
-int load_program(int reg_b, int reg_c, Seq_T mem, UArray_T reg);
-void load_value(int reg_a, int val, UArray_T reg);
-void segment_load_store_error(Seq_T mem, int segment_ind, int word_ind);
+static inline void word_interpreter(Mem_T mem, Register_T registers);
+static inline void conditional_move(int reg_a, int reg_b, int reg_c,
+                                    Register_T reg);
+static inline void segmented_load(int reg_a, int reg_b, int reg_c, Mem_T mem,
+                                  Register_T reg);
+static inline void segmented_store(int reg_a, int reg_b, int reg_c, Mem_T mem,
+                                   Register_T reg);
+static inline void addition(int reg_a, int reg_b, int reg_c, Register_T reg);
+static inline void multiplication(int reg_a, int reg_b, int reg_c,
+                                  Register_T reg);
+static inline void division(int reg_a, int reg_b, int reg_c, Register_T reg);
+static inline void bitwise_nand(int reg_a, int reg_b, int reg_c,
+                                Register_T reg);
+static inline void map_segment(int reg_b, int reg_c, Mem_T mem,
+                               Register_T reg);
+static inline void unmap_segment(int reg_c, Mem_T mem, Register_T reg);
+static inline void output(int reg_c, Register_T reg);
+static inline void input(int reg_c, Register_T reg);
+static inline int load_program(int reg_b, int reg_c, Mem_T mem,
+                               Register_T reg);
+static inline void load_value(int reg_a, int val, Register_T reg);
+static inline void segment_load_store_error(Mem_T mem, uint32_t segment_ind,
+                              uint32_t word_ind);
 
 /****************************** initiate_program ******************************
  *
- * Creates registers, memory, and id manager that will be used during the
+ * Creates registers and memory that will be used during the
  * remainder of the program. Reads input from input file containing 
  * instructions to be executed, places them in memory and calls instruction 
  * executer.
  *
  * Inputs:
  *              FILE *fp: input file containing instructions
+ *              Mem_backend backend: how the segmented memory is stored
  * Return:
  *              n/a
  * Expects:
@@ -87,7 +97,7 @@ void segment_load_store_error(Seq_T mem, int segment_ind, int word_ind);
  *              will CRE if input file null
  *
  *****************************************************************************/
-void initiate_program(FILE *fp)
+void initiate_program(FILE *fp, Mem_backend backend)
 {
         assert(fp != NULL);
 
@@ -118,49 +128,48 @@ void initiate_program(FILE *fp)
                 c = getc(fp);
         }
 
-        /* initialize segment 0 and transfer qords from temp prog sequence to 
-         * seg_0 UArray
+        /* transfer words from temp prog sequence to an array that memory
+         * copies into segment 0
          */
         int proglen = Seq_length(prog);
-        UArray_T seg_0 = UArray_new(proglen, sizeof(uint32_t));
+        uint32_t *seg_0 = malloc((proglen == 0 ? 1 : proglen) *
+                                 sizeof(uint32_t));
+        assert(seg_0 != NULL);
         for (int i = 0; i < proglen; i++) {
-                *(uint32_t *)word_at(seg_0, i) = *(uint32_t *)Seq_get(prog, i);
+                uint32_t *word = Seq_remlo(prog);
+                seg_0[i] = *word;
+                free(word);
         }
+        Seq_free(&prog);
 
         /* memory is initialized with segment 0 filled with program */
-        Seq_T mem = memory_new(seg_0);
+        Mem_T mem = memory_new(backend, seg_0, proglen);
+        free(seg_0);
 
-        /* registers and id manager for program is set up */
-        Seq_T id_m = id_m_new();
-        UArray_T registers = register_new();
+        /* registers for program are set up */
+        Register_T registers = register_new();
 
         /* all program info is sent to helper function */
-        word_interpreter(mem, registers, id_m);
+        word_interpreter(mem, registers);
         
         /* frees all allocated space */
         memory_free(&mem);
         register_free(&registers);
-        free_seg(prog);
-
-        //MODULARITY NOTE: BUNUN ICIN FUNCTION GEREKIR MI?
-        // Seq_free(&id_m);
-        id_m_free(&id_m);
 }
 
 /****************************** word_interpreter ******************************
  *
  * Goes through each instruction provided and calls appropriate operations
  * with necessary parameters depending on opcode provided in the word. Uses
- * bitpack to unpack words and acquire necessary fields.
+ * shifts and masks to unpack words and acquire necessary fields.
  *
  * Inputs:
- *              Seq_T mem: sequence of UArrays of words representing memory
- *              UArray_T reg: UArray representing reg
- *              Seq_T id_m: id manager keeping track of free segments
+ *              Mem_T mem: segmented memory
+ *              Register_T reg: the 8 registers
  * Return:
  *              n/a
  * Expects:
- *              memory, reg and id manager to not be null
+ *              memory and reg to not be null
  * Notes:
  *              will CRE if expectations fail
  *              will URE if program does not end with halt or counter is out of
@@ -168,38 +177,40 @@ void initiate_program(FILE *fp)
  *              will URE if the instruction is not known
  *
  *****************************************************************************/
-void word_interpreter(Seq_T mem, UArray_T reg, Seq_T id_m)
+static inline void word_interpreter(Mem_T mem, Register_T reg)
 {
         assert(mem != NULL);
         assert(reg != NULL);
-        assert(id_m != NULL);
 
-        /* get the segment 0 for program */
-        UArray_T program = segment_at(mem, 0);
+        /* get the words of segment 0 for program */
+        uint32_t *program = segment_words(mem, 0);
 
         /* gets number of words in running program, segment 0 */
-        uint32_t length_p = get_length_seg(program);
+        uint32_t length_p = get_length_seg(mem, 0);
 
         /* halt being called at the end of the program will be checked later */
         bool halt_called = false;
 
         /* goes through each word in segment 0 to execute instructions */
         for (uint32_t p_counter = 0; p_counter < length_p; p_counter++) {
-                uint32_t curr_word = *(uint32_t *)word_at(program, p_counter);
-                Um_opcode op = Bitpack_getu(curr_word, 4, 28);
+                uint32_t curr_word = program[p_counter];
+                Um_opcode op = curr_word >> 28;
                 int ra = -1;
                 int rb = -1;
                 int rc = -1;
                 int value = -1;
 
-                /* populates related fields depending on operation code */
+                /* populates related fields depending on operation code. the
+                 * fields are masked in place rather than with Bitpack_getu,
+                 * so the compiler sees each register index is below 8
+                 */
                 if (op == LV) {
-                        ra = Bitpack_getu(curr_word, 3, 25);
-                        value = Bitpack_getu(curr_word, 25, 0);
+                        ra = (curr_word >> 25) & 0x7;
+                        value = curr_word & 0x1FFFFFF;
                 } else {
-                        ra = Bitpack_getu(curr_word, 3, 6);
-                        rb = Bitpack_getu(curr_word, 3, 3);
-                        rc = Bitpack_getu(curr_word, 3, 0);
+                        ra = (curr_word >> 6) & 0x7;
+                        rb = (curr_word >> 3) & 0x7;
+                        rc = curr_word & 0x7;
                 }
 
                 /* calls function for opcode in the instruction */
@@ -231,10 +242,10 @@ void word_interpreter(Seq_T mem, UArray_T reg, Seq_T id_m)
                                 halt_called = true;
                                 break;
                         case ACTIVATE:
-                                map_segment(rb, rc, mem, reg, id_m);
+                                map_segment(rb, rc, mem, reg);
                                 break;
                         case INACTIVATE:
-                                unmap_segment(rc, mem, reg, id_m);
+                                unmap_segment(rc, mem, reg);
                                 break;
                         case OUT:
                                 output(rc, reg);
@@ -245,8 +256,8 @@ void word_interpreter(Seq_T mem, UArray_T reg, Seq_T id_m)
                         case LOADP:
                                 /* update counter, program, and prog lenght */
                                 p_counter = load_program(rb, rc, mem, reg) - 1;
-                                program = segment_at(mem, 0);
-                                length_p = get_length_seg(program);
+                                program = segment_words(mem, 0);
+                                length_p = get_length_seg(mem, 0);
                                 break;
                         case LV:
                                 load_value(ra, value, reg);
@@ -272,7 +283,7 @@ void word_interpreter(Seq_T mem, UArray_T reg, Seq_T id_m)
  *              int reg_a: register index to update
  *              int reg_b: register index to retrieve the value from
  *              int reg_c: register index to check if zero
- *              UArray_T reg: UArray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
@@ -281,7 +292,8 @@ void word_interpreter(Seq_T mem, UArray_T reg, Seq_T id_m)
  *              will CRE if reg is null
  *
  *****************************************************************************/
-void conditional_move(int reg_a, int reg_b, int reg_c, UArray_T reg)
+static inline void conditional_move(int reg_a, int reg_b, int reg_c,
+                                    Register_T reg)
 {
         assert(reg != NULL);
         if (*(uint32_t *)value_at(reg, reg_c) != 0) {
@@ -299,8 +311,8 @@ void conditional_move(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              int reg_a: register index to update
  *              int reg_b: segment index
  *              int reg_c: offset index
- *              UArray_T reg: UArray representing 8 32-bit registers
- *              Seq_T mem: sequence of UArrays of words representing memory
+ *              Register_T reg: the 8 32-bit registers
+ *              Mem_T mem: segmented memory
  * Return:
  *              n/a
  * Expects:
@@ -312,21 +324,21 @@ void conditional_move(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *                      bounds of a mapped segment
  *
  *****************************************************************************/
-void segmented_load(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg)
+static inline void segmented_load(int reg_a, int reg_b, int reg_c, Mem_T mem,
+                                  Register_T reg)
 {
         assert(mem != NULL);
         assert(reg != NULL);
 
         /* Retrieve the segment and word indices */
         uint32_t segment_id = *(uint32_t *)value_at(reg, reg_b);
-        int word_id = *(uint32_t *)value_at(reg, reg_c);
+        uint32_t word_id = *(uint32_t *)value_at(reg, reg_c);
 
         /* Check that the segment is mapped and word index is in bounds */
         segment_load_store_error(mem, segment_id, word_id);
         
         /* Update value at reg index reg_a to be equal to the word in memory */
-        UArray_T seg = segment_at(mem, segment_id);
-        *(uint32_t *)value_at(reg, reg_a) = *(uint32_t *)word_at(seg, word_id);
+        *(uint32_t *)value_at(reg, reg_a) = *word_at(mem, segment_id, word_id);
 }
 
 /****************************** segmented_store ******************************
@@ -338,8 +350,8 @@ void segmented_load(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg)
  *              int reg_a: segment index 
  *              int reg_b: offset index
  *              int reg_c: register index to update
- *              UArray_T reg: UArray representing 8 32-bit registers
- *              Seq_T mem: sequence of UArrays of words representing memory
+ *              Register_T reg: the 8 32-bit registers
+ *              Mem_T mem: segmented memory
  * Return:
  *              n/a
  * Expects:
@@ -351,21 +363,21 @@ void segmented_load(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg)
  *                      bounds of a mapped segment
  *
  *****************************************************************************/
-void segmented_store(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg)
+static inline void segmented_store(int reg_a, int reg_b, int reg_c, Mem_T mem,
+                                   Register_T reg)
 {
         assert(mem != NULL);
         assert(reg != NULL);
         
         /* Retrieve the segment and word indices */
         uint32_t segment_ind = *(uint32_t *)value_at(reg, reg_a);
-        int word_ind = *(uint32_t *)value_at(reg, reg_b);
+        uint32_t word_ind = *(uint32_t *)value_at(reg, reg_b);
 
         /* Check that the segment is mapped and word index is in bounds */
         segment_load_store_error(mem, segment_ind, word_ind);
 
         /* Update value in memory to be equal to the word at reg index reg_c */
-        UArray_T seg = segment_at(mem, segment_ind);
-        uint32_t *new_word = word_at(seg, word_ind);
+        uint32_t *new_word = word_at(mem, segment_ind, word_ind);
         *new_word =  *(uint32_t *)value_at(reg, reg_c);
 }
 
@@ -375,9 +387,11 @@ void segmented_store(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg)
  * referred to is in bounds
  * 
  * Inputs:
- *              Seq_T mem: sequence of UArrays of words representing memory
- *              int segment_ind: segment id in the memory being referred to
- *              int word_ind: word offset in the segment being referred to
+ *              Mem_T mem: segmented memory
+ *              uint32_t segment_ind: segment id in the memory being referred
+ *                                    to
+ *              uint32_t word_ind: word offset in the segment being referred
+ *                                 to
  * Return:
  *              n/a
  * Expects:
@@ -389,13 +403,14 @@ void segmented_store(int reg_a, int reg_b, int reg_c, Seq_T mem, UArray_T reg)
  *                       of a mapped segment
  *
  *****************************************************************************/
-void segment_load_store_error(Seq_T mem, int segment_ind, int word_ind)
+static inline void segment_load_store_error(Mem_T mem, uint32_t segment_ind,
+                                            uint32_t word_ind)
 {
         assert(mem != NULL);
-        if (segment_at(mem, segment_ind) == NULL) {
+        if (!segment_mapped(mem, segment_ind)) {
                 RAISE(Segment_Unmapped);
         }
-        if (word_ind >= get_length_seg(segment_at(mem, segment_ind))) {
+        if (word_ind >= get_length_seg(mem, segment_ind)) {
                 RAISE(Word_Bounds);
         }
 
@@ -409,7 +424,7 @@ void segment_load_store_error(Seq_T mem, int segment_ind, int word_ind)
  *              int reg_a: register index to store sum in
  *              int reg_b: register index to retrieve the value from
  *              int reg_c: register index to retrieve the value from
- *              UArray_T reg: UArray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
@@ -418,7 +433,7 @@ void segment_load_store_error(Seq_T mem, int segment_ind, int word_ind)
  *              will CRE if reg is null
  *
  *****************************************************************************/
-void addition(int reg_a, int reg_b, int reg_c, UArray_T reg)
+static inline void addition(int reg_a, int reg_b, int reg_c, Register_T reg)
 {
         assert(reg != NULL);
 
@@ -439,7 +454,7 @@ void addition(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              int reg_a: register index to store product in
  *              int reg_b: register index to retrieve the value from
  *              int reg_c: register index to retrieve the value from
- *              UArray_T reg: UArray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
@@ -448,7 +463,8 @@ void addition(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              will CRE if reg is null
  *
  *****************************************************************************/
-void multiplication(int reg_a, int reg_b, int reg_c, UArray_T reg)
+static inline void multiplication(int reg_a, int reg_b, int reg_c,
+                                  Register_T reg)
 {
         assert(reg != NULL);
 
@@ -469,7 +485,7 @@ void multiplication(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              int reg_a: register index to store product in
  *              int reg_b: register index to retrieve the value from
  *              int reg_c: register index to retrieve the value from
- *              UArray_T reg: UArray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
@@ -479,7 +495,7 @@ void multiplication(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              will URE if divisor is 0
  *
  *****************************************************************************/
-void division(int reg_a, int reg_b, int reg_c, UArray_T reg)
+static inline void division(int reg_a, int reg_b, int reg_c, Register_T reg)
 {
         assert(reg != NULL);
 
@@ -505,7 +521,7 @@ void division(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              int reg_a: register index to store result in
  *              int reg_b: register index to retrieve the value from
  *              int reg_c: register index to retrieve the value from
- *              UArray_T reg: UArray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
@@ -514,7 +530,8 @@ void division(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              will CRE if reg is null
  *
  *****************************************************************************/
-void bitwise_nand(int reg_a, int reg_b, int reg_c, UArray_T reg)
+static inline void bitwise_nand(int reg_a, int reg_b, int reg_c,
+                                Register_T reg)
 {
         assert(reg != NULL);
 
@@ -539,43 +556,24 @@ void bitwise_nand(int reg_a, int reg_b, int reg_c, UArray_T reg)
  *              int reg_b: register index to store the segment value in
  *              int reg_c: register index to retrieve the number of words to 
  *                         map
- *              UArray_T reg: UArray representing 8 32-bit registers
- *              Seq_T mem: sequence of UArrays of words representing memory
- *              Seq_T id_m: sequence of segment ids available to be mapped
+ *              Register_T reg: the 8 32-bit registers
+ *              Mem_T mem: segmented memory
  * Return:
  *              n/a
  * Expects:
- *              register, memory, id_m to not be null
+ *              register and memory to not be null
  * Notes:
  *              will CRE if expectations fail
  *
  *****************************************************************************/
-void map_segment(int reg_b, int reg_c, Seq_T mem, UArray_T reg, Seq_T id_m)
+static inline void map_segment(int reg_b, int reg_c, Mem_T mem, Register_T reg)
 {
         assert(mem != NULL);
         assert(reg != NULL);
-        assert(id_m != NULL);
 
-        /* initialize the new segment with 0's as words */
-        int num_words = *(uint32_t *)value_at(reg, reg_c);
-        UArray_T new_seg = UArray_new(num_words, sizeof(uint32_t));
-        for (int i = 0; i < num_words; i++) {
-                *(uint32_t *)word_at(new_seg, i) = (uint32_t)0;
-        }
-        
-        uint32_t segment_id = 0;
-        
-        /* if there is no space available in the current memory, add segment to
-         * the end. if there is, place the segment to an unmapped location 
-         * retrieved from id_m. update new segment_id
-         */
-        if (get_length(id_m) == 0) {
-                segment_add(mem, new_seg);
-                segment_id = get_length(mem) - 1;
-        } else {
-                segment_id = id_m_pop(id_m);
-                segment_put(mem, segment_id, new_seg);
-        }
+        /* the memory maps a zeroed segment, reusing an unmapped id if any */
+        uint32_t num_words = *(uint32_t *)value_at(reg, reg_c);
+        uint32_t segment_id = segment_map(mem, num_words);
 
         /* store new segment id in register with index reg_b */
         *(uint32_t *)value_at(reg, reg_b) = (uint32_t)segment_id;
@@ -590,45 +588,38 @@ void map_segment(int reg_b, int reg_c, Seq_T mem, UArray_T reg, Seq_T id_m)
  * Inputs:
  *              int reg_c: register index to retrieve the segment id to be 
  *                         freed
- *              UArray_T reg: UArray representing 8 32-bit registers
- *              Seq_T mem: sequence of UArrays of words representing memory
- *              Seq_T id_m: sequence of segment ids available to be mapped
+ *              Register_T reg: the 8 32-bit registers
+ *              Mem_T mem: segmented memory
  * Return:
  *              n/a
  * Expects:
- *              register, memory, id_m to not be null
+ *              register and memory to not be null
  * Notes:
  *              will CRE if expectations fail
  *              will URE if segment 0 or an already unmapped segment are tried 
  *                      to be unmapped
  *
  *****************************************************************************/
-void unmap_segment(int reg_c, Seq_T mem, UArray_T reg, Seq_T id_m)
+static inline void unmap_segment(int reg_c, Mem_T mem, Register_T reg)
 {
         assert(mem != NULL);
         assert(reg != NULL);
-        assert(id_m != NULL);
         
-        /* retrieve the segment id to be unmapped and add it to free ids seq */
+        /* retrieve the segment id to be unmapped */
         uint32_t segment_ind = *(uint32_t *)value_at(reg, reg_c);
-        id_m_add(id_m, segment_ind);
 
         /* raise an error if the user tries to unmap segment 0 */
         if (segment_ind == 0) {
                 RAISE(Faulty_Unmap);
         }
         
-        /* retrieve the segment to be unmapped */
-        UArray_T unmap_seg = segment_at(mem, segment_ind);
-        
         /* raise an error if the user tries to unmap a not mapped segment */
-        if (unmap_seg == NULL) {
+        if (!segment_mapped(mem, segment_ind)) {
                 RAISE(Faulty_Unmap);
         }
         
-        /* frees segment to be unmapped and places NULL in its place */
-        UArray_free(&unmap_seg);
-        segment_put(mem, segment_ind, NULL);
+        /* frees segment to be unmapped, its id can be mapped again */
+        segment_unmap(mem, segment_ind);
 }
 
 
@@ -638,18 +629,18 @@ void unmap_segment(int reg_c, Seq_T mem, UArray_T reg, Seq_T id_m)
  *
  * Inputs:
  *              int reg_c: register index to retrieve the value from
- *              UArray_T reg: UArray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
- *              register UArray to not be null and for the input value to be 
+ *              registers to not be null and for the input value to be 
  *              in the range 0-255
  * Notes:
  *              will CRE if reg is null
  *              will URE with IO_Bounds if the output is not in bounds
  *
  *****************************************************************************/
-void output(int reg_c, UArray_T reg)
+static inline void output(int reg_c, Register_T reg)
 {
         assert(reg != NULL);
         
@@ -673,18 +664,18 @@ void output(int reg_c, UArray_T reg)
  *
  * Inputs:
  *              int reg_c: register index to place the input at
- *              UArray_T reg: uarray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
- *              register uarray to not be null and for the input value to be 
+ *              registers to not be null and for the input value to be 
  *              in the range 0-255
  * Notes:
  *              will CRE if reg is null
  *              will URE with IO_Bounds if the input is not in bounds
  *
  *****************************************************************************/
-void input(int reg_c, UArray_T reg)
+static inline void input(int reg_c, Register_T reg)
 {
         assert(reg != NULL);
 
@@ -717,8 +708,8 @@ void input(int reg_c, UArray_T reg)
  * Inputs:
  *              int reg_b: segment index to replace segment zero
  *              int reg_c: program counter to jump to a word in a segment
- *              Seq_T mem: sequence of UArrays of words representing memory
- *              UArray_T reg: uarray representing 8 32-bit registers
+ *              Mem_T mem: segmented memory
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              int representing new program counter value
  * Expects:
@@ -727,7 +718,7 @@ void input(int reg_c, UArray_T reg)
  *              will CRE if expectations fail
  *
  *****************************************************************************/
-int load_program(int reg_b, int reg_c, Seq_T mem, UArray_T reg)
+static inline int load_program(int reg_b, int reg_c, Mem_T mem, Register_T reg)
 {
         /* checks for requirements */
         assert(mem != NULL);
@@ -738,30 +729,13 @@ int load_program(int reg_b, int reg_c, Seq_T mem, UArray_T reg)
         
         /* if segment to replace segment 0 is not segment 0 itself: */
         if (value_b != 0) {
-                /* segment at 0 is unmapped and freed */
-                UArray_T unmap_seg = segment_at(mem, 0);                
-                
-                UArray_free(&unmap_seg);
-                segment_put(mem, 0, NULL);
-
                 /* duplicates the segmnt to be put at segment 0 */
-                UArray_T dup = segment_at(mem, value_b);
-                if (dup == NULL) {
+                if (!segment_mapped(mem, value_b)) {
                         RAISE(Segment_Unmapped);
                 }
-                int num_words = get_length_seg(dup);
 
-                /* initiates a new segment with number of words defined */
-                UArray_T new_seg = UArray_new(num_words, sizeof(uint32_t));
-
-                /* adds words from the original segment to the duplicate */
-                for (int i = 0; i < num_words; i++) {
-                        *(uint32_t *)word_at(new_seg, i) = 
-                                                  *(uint32_t *)word_at(dup, i);
-                }
-                
-                /* segment is duplicated and put into segment 0 */
-                segment_put(mem, 0, new_seg);
+                /* segment at 0 is freed and replaced with the duplicate */
+                segment_duplicate(mem, value_b);
         }
 
         /* new program counter is returned */
@@ -776,16 +750,16 @@ int load_program(int reg_b, int reg_c, Seq_T mem, UArray_T reg)
  * Inputs:
  *              int reg_a: register index to place the value at
  *              int val: the value to move into the register
- *              UArray_T reg: uarray representing 8 32-bit registers
+ *              Register_T reg: the 8 32-bit registers
  * Return:
  *              n/a
  * Expects:
- *              register uarray to not be null
+ *              registers to not be null
  * Notes:
  *              will CRE if expectations fail
  *
  *****************************************************************************/
-void load_value(int reg_a, int val, UArray_T reg)
+static inline void load_value(int reg_a, int val, Register_T reg)
 {
         assert(reg != NULL);
         
@@ -20,7 +20,9 @@
 #include <stdio.h>
 #include <stdint.h>
 
+/* Custom .h files */
+#include "memory_management.h"
 
-extern void initiate_program(FILE *fp);
+extern void initiate_program(FILE *fp, Mem_backend backend);
 
 #endif
\ No newline at end of file
@@ -7,7 +7,10 @@
  *      Interface for the register.c file. Functions in this file are
  *      used to create a register structure with 8 32-bit containers, retrieve
  *      the value stored at a register, and free the structure. 
- * 
+ *
+ *      The registers are a plain struct holding an array of 8 uint32_t's,
+ *      and the functions are static inline so a register access compiles
+ *      down to one load or store in the caller.
  */
 
 
@@ -17,12 +20,103 @@
 /* Standard C Libraries */
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 
 /* Hanson Libraries */
-#include <uarray.h>
+#include <assert.h>
+#include <except.h>
+#include <mem.h>
+
+/* number of registers */
+#define REG_SIZE 8
+
+/* the 8 32-bit registers */
+typedef struct Register_T {
+        uint32_t values[REG_SIZE];
+} *Register_T;
+
+/* About: This exception is raised when client attempts access
+ *        to an index that is out of bounds.
+ */
+extern Except_T Bad_Bounds_Register;
+
+/*********************** register_new *******************************
+ *
+ * used when initiating the program, to create the 8 32-bit registers
+ *
+ * Inputs:
+ *              n/a
+ * Return:
+ *              Register_T: 8 registers, with all values set to 0
+ * Expects:
+ *              n/a
+ * Notes:
+ *              CRE if space not allocated properly for reg.
+ *              it's the user's responsibility to call register_free 
+ *              to free the registers
+ *
+ ********************************************************************/
+static inline Register_T register_new(void)
+{
+        Register_T reg;
+        NEW0(reg);
+        assert(reg != NULL);
+
+        return reg;
+}
+
+/*********************** value_at **************************************
+ *
+ * used when retrieving value at register with provided index
+ *
+ * Inputs:
+ *              Register_T reg: the 8 registers
+ *              int index: represents register index to retrieve value from
+ * Return:
+ *              pointer to the value in the register
+ * Expects:
+ *              reg is not null and index is in bounds
+ * Notes:
+ *              CRE if reg is null or URE if index out of bounds with 
+ *              Bad_Bounds_Register exception. callers passing a 3-bit field
+ *              get the bounds check compiled away
+ *
+ **********************************************************************/
+static inline uint32_t *value_at(Register_T reg, int index)
+{
+        /* checks for requirements */
+        assert(reg != NULL);
+
+        if ((unsigned)index >= REG_SIZE) {
+                RAISE(Bad_Bounds_Register);
+        }
+
+        return &reg->values[index];
+}
+
+/*********************** register_free **************************************
+ *
+ * frees all register related space
+ *
+ * Inputs:
+ *              Register_T *reg: pointer to the 8 registers
+ * Return:
+ *              n/a
+ * Expects:
+ *              reg is not null and pointer to reg is not null
+ * Notes:
+ *              CRE if expectations fail
+ *
+ **********************************************************************/
+static inline void register_free(Register_T *reg)
+{
+        /* checks for expectations */
+        assert(reg != NULL);
+        assert(*reg != NULL);
+
+        FREE(*reg);
+}
 
-extern UArray_T register_new();
-extern void *value_at(UArray_T reg, int index);
-extern void register_free(UArray_T *reg);
+#undef REG_SIZE
 
-#endif
\ No newline at end of file
+#endif